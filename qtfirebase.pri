@@ -13,6 +13,11 @@ exists(.git) {
     SOURCES += $$PWD/qtfirebase_register.cpp
 }
 
+# Compile all debug output out of the library (warnings are kept)
+contains(QTFIREBASE_CONFIG,"nodebuglog") {
+    DEFINES += QTFIREBASE_NO_DEBUG_LOG
+}
+
 contains(QTFIREBASE_CONFIG,"analytics") {
     DEFINES += QTFIREBASE_BUILD_ANALYTICS
 }
@@ -6,6 +6,20 @@
 
 #include "qqml.h"
 
+#if defined(QTFIREBASE_STUB_BUILD)
+#include "stub/src/qtfirebasemetrics.h"
+#else
+#include "src/qtfirebasemetrics.h"
+#endif
+
+static QObject *QtFirebaseMetricsProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(scriptEngine)
+    // Process wide object, QML must not take ownership
+    engine->setObjectOwnership(qFirebaseMetrics, QQmlEngine::CppOwnership);
+    return qFirebaseMetrics;
+}
+
 #if defined(QTFIREBASE_BUILD_ALL) || defined(QTFIREBASE_BUILD_ANALYTICS)
 
 #if defined(QTFIREBASE_STUB_BUILD)
@@ -96,6 +110,7 @@ static QObject *QtFirebaseStorageProvider(QQmlEngine *engine, QJSEngine *scriptE
 static void registerQtFirebase() {
 
     qmlRegisterType<QtFirebaseGetInstanceRequest>("QtFirebase", 1, 0, "GetInstanceRequest");
+    qmlRegisterSingletonType<QtFirebaseMetrics>("QtFirebase", 1, 0, "Metrics", QtFirebaseMetricsProvider);
 
 #if defined(QTFIREBASE_BUILD_ALL) || defined(QTFIREBASE_BUILD_ANALYTICS)
     qmlRegisterType<QtFirebaseAnalytics>("QtFirebase", 1, 0, "Analytics");
@@ -125,6 +140,8 @@ static void registerQtFirebase() {
     qmlRegisterSingletonType<QtFirebaseDatabase>("QtFirebase", 1, 0, "Database", QtFirebaseDatabaseProvider);
     qmlRegisterUncreatableType<QtFirebaseDatabaseQuery>("QtFirebase", 1, 0, "DatabaseQuery", "Get query object from DatabaseRequest, do not create it");
     qmlRegisterType<QtFirebaseDatabaseRequest>("QtFirebase", 1, 0, "DatabaseRequest");
+    qmlRegisterType<QtFirebaseDatabaseListener>("QtFirebase", 1, 0, "DatabaseListener");
+    qmlRegisterType<QtFirebaseDatabaseListModel>("QtFirebase", 1, 0, "DatabaseListModel");
     qmlRegisterUncreatableType<QtFirebaseDataSnapshot>("QtFirebase", 1, 0, "DataSnapshot", "Get snapshot object from DatabaseRequest, do not create it");
 #endif
 
@@ -20,12 +20,28 @@ INCLUDEPATH += \
 HEADERS += \
     $$PWD/src/platformutils.h \
     $$PWD/src/qtfirebase.h \
+    $$PWD/src/qtfirebasearena.h \
+    $$PWD/src/qtfirebasebinding.h \
+    $$PWD/src/qtfirebasefuture.h \
+    $$PWD/src/qtfirebasefutureregistry.h \
+    $$PWD/src/qtfirebaseinitscheduler.h \
+    $$PWD/src/qtfirebasejson.h \
+    $$PWD/src/qtfirebaselogging.h \
+    $$PWD/src/qtfirebasemetrics.h \
     $$PWD/src/qtfirebaseservice.h \
+    $$PWD/src/qtfirebasetimerwheel.h \
     \
 
 SOURCES += \
     $$PWD/src/qtfirebase.cpp \
+    $$PWD/src/qtfirebasearena.cpp \
+    $$PWD/src/qtfirebasefutureregistry.cpp \
+    $$PWD/src/qtfirebaseinitscheduler.cpp \
+    $$PWD/src/qtfirebasejson.cpp \
+    $$PWD/src/qtfirebaselogging.cpp \
+    $$PWD/src/qtfirebasemetrics.cpp \
     $$PWD/src/qtfirebaseservice.cpp \
+    $$PWD/src/qtfirebasetimerwheel.cpp \
     \
 
 contains(QTPLUGIN,qtfirebase) {
@@ -1,4 +1,5 @@
 #include "platformutils.h"
+#include "qtfirebaselogging.h"
 
 #if defined(Q_OS_ANDROID)
 jobject PlatformUtils::nativeWindow = nullptr;
@@ -14,7 +15,7 @@ GooglePlayServices::Availability GooglePlayServices::getAvailability()
     QAndroidJniObject activity = QtAndroid::androidActivity();
 
     auto availablity = ::google_play_services::CheckAvailability(env, activity.object());
-    qDebug() << "GooglePlayServices::getAvailability result :" << availablity << " (0 is kAvailabilityAvailable)";
+    qtfbDebug(lcQtFirebase) << "GooglePlayServices::getAvailability result :" << availablity << " (0 is kAvailabilityAvailable)";
     return Availability(availablity);
 }
 
@@ -24,7 +25,7 @@ bool GooglePlayServices::available()
     QAndroidJniObject activity = QtAndroid::androidActivity();
 
     auto availablity = ::google_play_services::CheckAvailability(env, activity.object());
-    qDebug() << "GooglePlayServices::available() result :" << availablity << " (0 is kAvailabilityAvailable)";
+    qtfbDebug(lcQtFirebase) << "GooglePlayServices::available() result :" << availablity << " (0 is kAvailabilityAvailable)";
     return ::google_play_services::kAvailabilityAvailable == availablity;
 }
 #endif
@@ -48,6 +49,6 @@ jobject PlatformUtils::getNativeWindow()
 #else
 void PlatformUtils::getNativeWindow()
 {
-    qDebug() << "Not available";
+    qtfbDebug(lcQtFirebase) << "Not available";
 }
 #endif
@@ -1,32 +1,58 @@
 #include "qtfirebase.h"
 #include "firebase/instance_id.h"
-#include <QMutableMapIterator>
+#include <QPointer>
 #include <QThread>
 #include <firebase/instance_id.h>
 
 QtFirebase *QtFirebase::self = nullptr;
 
-QtFirebase::QtFirebase(QObject* parent) : QObject(parent)
+QtFirebase::QtFirebase(QObject* parent) : QObject(parent),
+    _deadlines(100)
 {
     _ready = false;
 
-    qDebug() << self << ":QtFirebase(QObject* parent)" ;
+    qtfbDebug(lcQtFirebase) << self << ":QtFirebase(QObject* parent)" ;
 
     Q_ASSERT_X(!self, "QtFirebase", "there should be only one firebase object");
     QtFirebase::self = this;
 
-    // NOTE where having trouble getting a valid UIView pointer using just signals.
-    // So this is a hack that let's us check the pointer every 1 seconds during startup.
-    // We should probably set a limit to how many checks should be done before giving up?
+    // NOTE the Firebase App needs a native window (UIView / Activity) on mobile.
+    // Instead of polling for it, the App is created as soon as a window is exposed or
+    // the application becomes active. The first attempt is made on the next event loop
+    // iteration, which is enough on platforms that don't need a window.
+    // A slow fallback timer covers platforms that deliver neither event.
     //connect(qGuiApp,&QGuiApplication::focusWindowChanged, this, &QtFirebase::init); // <-- Crashes on iOS
+    _clock.start();
+
+    // Created up front so QTFIREBASE_METRICS_FILE is honored without QML touching the Metrics singleton
+    QtFirebaseMetrics::instance();
+
+    _initScheduler = new QtFirebaseInitScheduler(self);
+    connect(_initScheduler, &QtFirebaseInitScheduler::allReadyChanged, self, &QtFirebase::modulesReadyChanged);
+
     _initTimer = new QTimer(self);
     _initTimer->setSingleShot(false);
     connect(_initTimer, &QTimer::timeout, self, &QtFirebase::requestInit);
     _initTimer->start(1000);
 
+    if(qGuiApp) {
+        qGuiApp->installEventFilter(self);
+        connect(qGuiApp, &QGuiApplication::applicationStateChanged, self, [this](Qt::ApplicationState state) {
+            if(state == Qt::ApplicationActive)
+                scheduleInit();
+        });
+    }
+    scheduleInit();
+
     _futureWatchTimer = new QTimer(self);
     _futureWatchTimer->setSingleShot(false);
     connect(_futureWatchTimer, &QTimer::timeout, self, &QtFirebase::processEvents);
+
+    // One timer drives the deadlines of all futures
+    _deadlineTimer = new QTimer(self);
+    _deadlineTimer->setSingleShot(false);
+    _deadlineTimer->setTimerType(Qt::CoarseTimer);
+    connect(_deadlineTimer, &QTimer::timeout, self, &QtFirebase::processDeadlines);
 }
 
 QtFirebase::~QtFirebase()
@@ -39,7 +65,7 @@ bool QtFirebase::checkInstance(const char *function)
 {
     bool b = (QtFirebase::self != nullptr);
     if (!b)
-        qWarning("QtFirebase::%s: Please instantiate the QtFirebase object first", function);
+        qCWarning(lcQtFirebase, "QtFirebase::%s: Please instantiate the QtFirebase object first", function);
     return b;
 }
 
@@ -51,16 +77,16 @@ bool QtFirebase::ready() const
 void QtFirebase::waitForFutureCompletion(firebase::FutureBase future)
 {
     static int count = 0;
-    qDebug() << self << "::waitForFutureCompletion" << "waiting for future" << &future << "completion. Initial status" << future.status();
+    qtfbDebug(lcQtFirebase) << self << "::waitForFutureCompletion" << "waiting for future" << &future << "completion. Initial status" << future.status();
     while(future.status() == firebase::kFutureStatusPending) {
         QGuiApplication::processEvents();
         count++;
 
         if(count % 100 == 0)
-            qDebug() << count << "Future" << &future << "is still pending. Has current status" << future.status();
+            qtfbDebug(lcQtFirebase) << count << "Future" << &future << "is still pending. Has current status" << future.status();
 
         if(count % 200 == 0) {
-            qDebug() << count << "Future" << &future << "is still pending. Something is probably wrong. Breaking wait cycle. Current status" << future.status();
+            qtfbDebug(lcQtFirebase) << count << "Future" << &future << "is still pending. Something is probably wrong. Breaking wait cycle. Current status" << future.status();
             count = 0;
             break;
         }
@@ -69,15 +95,15 @@ void QtFirebase::waitForFutureCompletion(firebase::FutureBase future)
     count = 0;
 
     if(future.status() == firebase::kFutureStatusComplete) {
-       qDebug() << self << "::waitForFutureCompletion" << "ended with COMPLETE";
+       qtfbDebug(lcQtFirebase) << self << "::waitForFutureCompletion" << "ended with COMPLETE";
     }
 
     if(future.status() == firebase::kFutureStatusInvalid) {
-       qDebug() << self << "::waitForFutureCompletion" << "ended with INVALID";
+       qtfbDebug(lcQtFirebase) << self << "::waitForFutureCompletion" << "ended with INVALID";
     }
 
     if(future.status() == firebase::kFutureStatusPending) {
-       qDebug() << self << "::waitForFutureCompletion" << "ended with PENDING";
+       qtfbDebug(lcQtFirebase) << self << "::waitForFutureCompletion" << "ended with PENDING";
     }
 }
 
@@ -88,20 +114,103 @@ firebase::App* QtFirebase::firebaseApp() const
 
 void QtFirebase::addFuture(const QString &eventId, const firebase::FutureBase &future)
 {
-    qDebug() << self << "::addFuture" << "adding" << eventId;
+    qtfbDebug(lcQtFirebase) << self << "::addFuture" << "adding" << eventId;
 
-    if (_futureMap.contains(eventId))
-    {
-        qWarning() << "_futureMap already contains '" << eventId << "'.";
+    addFuture(future, [this, eventId](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+        Q_UNUSED(handle)
+        emit futureEvent(eventId, completed);
+    });
+}
+
+QtFirebaseFutureHandle QtFirebase::addFuture(const firebase::FutureBase &future, const QtFirebaseFutureRegistry::Callback &callback, int timeout, QtFirebaseMetrics::Operation operation)
+{
+    const qint64 started = operation != QtFirebaseMetrics::None ? QtFirebaseMetrics::begin(operation) : 0;
+    const QtFirebaseFutureHandle handle = _futures.insert(future, callback, operation, started);
+
+    if(timeout > 0) {
+        const qint64 now = _clock.elapsed();
+        _deadlines.schedule(handle, now + timeout, now);
+        if(!_deadlineTimer->isActive())
+            _deadlineTimer->start(_deadlines.tickInterval());
     }
 
-    _futureMap.insert(eventId,future);
+    // Let the SDK tell us when the future is done so the result is dispatched
+    // on the next event loop iteration instead of on the next watch timer tick.
+    // NOTE this replaces any completion callback the caller set (see header)
+    future.OnCompletion(&QtFirebase::onFutureCompleted, this);
 
-    //if(!_futureWatchTimer->isActive()) {
-    qDebug() << self << "::addFuture" << "starting future watch";
-    _futureWatchTimer->start(1000);
-    //}
+    // The watch timer is only a fallback for futures that never report back
+    if(!_futureWatchTimer->isActive()) {
+        qtfbDebug(lcQtFirebase) << self << "::addFuture" << "starting future watch";
+        _futureWatchTimer->start(1000);
+    }
 
+    return handle;
+}
+
+QtFirebaseFutureHandle QtFirebase::addFuture(const firebase::FutureBase &future, QObject *receiver, const QtFirebaseFutureRegistry::Callback &callback, int timeout, QtFirebaseMetrics::Operation operation)
+{
+    if(receiver && !_futureReceivers.contains(receiver)) {
+        _futureReceivers.insert(receiver);
+        connect(receiver, &QObject::destroyed, this, [this](QObject *object) {
+            _futureReceivers.remove(object);
+        });
+    }
+
+    // The callback is dropped if the receiver is gone by the time the future completes
+    QPointer<QObject> guard(receiver);
+    return addFuture(future, [this, guard, callback](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+        if(!guard)
+            return;
+
+        // Measured at delivery: a broadcast would reach every receiver alive now
+        const int receivers = _futureReceivers.size();
+        _routedFutureEvents++;
+        if(receivers > 1)
+            _savedFutureDispatches += static_cast<quint64>(receivers - 1);
+        QtFirebaseMetrics::routed(receivers);
+        callback(handle, completed);
+    }, timeout, operation);
+}
+
+bool QtFirebase::removeFuture(QtFirebaseFutureHandle handle)
+{
+    _deadlines.cancel(handle);
+
+    QtFirebaseFutureRegistry::Entry entry;
+    if(!_futures.take(handle, entry))
+        return false;
+
+    recordMetrics(entry, QtFirebaseMetrics::ErrorCancelled);
+    return true;
+}
+
+void QtFirebase::recordMetrics(const QtFirebaseFutureRegistry::Entry &entry, int error)
+{
+    if(entry.operation >= 0)
+        QtFirebaseMetrics::end(static_cast<QtFirebaseMetrics::Operation>(entry.operation), entry.started, error);
+}
+
+quint64 QtFirebase::routedFutureEvents() const
+{
+    return _routedFutureEvents;
+}
+
+quint64 QtFirebase::savedFutureDispatches() const
+{
+    return _savedFutureDispatches;
+}
+
+void QtFirebase::onFutureCompleted(const firebase::FutureBase &future, void *userData)
+{
+    Q_UNUSED(future)
+
+    // NOTE this is called on whatever thread the SDK completes the future on
+    // (or directly from OnCompletion if the future is already done).
+    // Only post one queued processEvents() at a time - it handles all completed futures.
+    QtFirebase *qtFirebase = static_cast<QtFirebase *>(userData);
+    if(qtFirebase->_processEventsQueued.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(qtFirebase, "processEvents", Qt::QueuedConnection);
 }
 
 void QtFirebase::setOptions(const firebase::AppOptions &options)
@@ -113,7 +222,7 @@ void QtFirebase::requestInit()
 {
     #if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
     if(!PlatformUtils::getNativeWindow()) {
-        qDebug() << self << "::requestInit" << "no native UI pointer";
+        qtfbDebug(lcQtFirebase) << self << "::requestInit" << "no native UI pointer";
         return;
     }
     #endif
@@ -136,42 +245,125 @@ void QtFirebase::requestInit()
 
         #endif
 
-        qDebug("QtFirebase::requestInit created the Firebase App (%x)",static_cast<int>(reinterpret_cast<intptr_t>(_firebaseApp)));
+        qtfbDebug(lcQtFirebase) << "QtFirebase::requestInit created the Firebase App" << static_cast<void *>(_firebaseApp);
 
         _initTimer->stop();
-        delete _initTimer;
+        _initTimer->deleteLater();
+        _initTimer = nullptr;
+        if(qGuiApp)
+            qGuiApp->removeEventFilter(self);
 
         _ready = true;
-        qDebug() << self << "::requestInit" << "initialized";
+        qtfbDebug(lcQtFirebase) << self << "::requestInit" << "initialized";
+        recordStartup(QStringLiteral("QtFirebase"));
         emit readyChanged();
     }
 }
 
-void QtFirebase::processEvents()
+void QtFirebase::scheduleInit()
 {
-    qDebug() << self << "::processEvents" << "processing events";
-    QMutableMapIterator<QString, firebase::FutureBase> i(_futureMap);
-    while (i.hasNext()) {
-        i.next();
-        if(i.value().status() != firebase::kFutureStatusPending) {
-            qDebug() << self << "::processEvents" << "future event" << i.key();
-            //if(_futureMap.remove(i.key()) >= 1) //QMap holds only one key. Use QMultiMap for multiple keys.
-            const auto key = i.key();
-            const auto value = i.value();
-            i.remove();
-            qDebug() << self << "::processEvents" << "removed future event" << key;
-            emit futureEvent(key, value);
-            // To easen events up:
-            //break;
-        }
+    // Several windows may be exposed at once, one queued attempt is enough
+    if(_ready || _initQueued)
+        return;
+
+    _initQueued = true;
+    QMetaObject::invokeMethod(this, "tryInit", Qt::QueuedConnection);
+}
 
+void QtFirebase::tryInit()
+{
+    _initQueued = false;
+    requestInit();
+}
+
+bool QtFirebase::eventFilter(QObject *watched, QEvent *event)
+{
+    // Only installed on the application until the Firebase App is created
+    if(event->type() == QEvent::Expose) {
+        QWindow *window = qobject_cast<QWindow *>(watched);
+        if(window && window->isExposed())
+            scheduleInit();
     }
+    return QObject::eventFilter(watched, event);
+}
+
+QVariantList QtFirebase::startupTimeline() const
+{
+    return _startupTimeline;
+}
+
+void QtFirebase::recordStartup(const QString &module)
+{
+    QVariantMap milestone;
+    milestone.insert(QStringLiteral("module"), module);
+    milestone.insert(QStringLiteral("elapsed"), _clock.elapsed());
+    _startupTimeline.append(milestone);
+
+    qtfbDebug(lcQtFirebase) << self << "::recordStartup" << module << "ready after" << _clock.elapsed() << "ms";
+    emit startupTimelineChanged();
 
-    if(_futureMap.isEmpty()) {
-        qDebug() << self << "::processEvents" << "stopping future watch";
+    _initScheduler->markReady(module);
+}
+
+QtFirebaseInitScheduler *QtFirebase::initScheduler() const
+{
+    return _initScheduler;
+}
+
+bool QtFirebase::modulesReady() const
+{
+    return _initScheduler->allReady();
+}
+
+void QtFirebase::processEvents()
+{
+    // Reset before scanning so completions arriving during the scan queue a new run
+    _processEventsQueued.storeRelease(0);
+
+    qtfbDebug(lcQtFirebase) << self << "::processEvents" << "processing events";
+
+    // Completed entries are taken out before any callback runs,
+    // callbacks are free to add new futures
+    QVector<QtFirebaseFutureRegistry::Entry> completed;
+    _futures.takeCompleted(completed);
+    for(const QtFirebaseFutureRegistry::Entry &entry : completed) {
+        qtfbDebug(lcQtFirebase) << self << "::processEvents" << "future event" << entry.handle;
+        _deadlines.cancel(entry.handle);
+        recordMetrics(entry, QtFirebaseMetrics::errorOf(entry.future));
+        entry.callback(entry.handle, entry.future);
+    }
+
+    if(_futures.isEmpty()) {
+        qtfbDebug(lcQtFirebase) << self << "::processEvents" << "stopping future watch";
         _futureWatchTimer->stop();
     }
 
+    if(_deadlines.isEmpty())
+        _deadlineTimer->stop();
+}
+
+void QtFirebase::processDeadlines()
+{
+    QVector<QtFirebaseFutureHandle> expired;
+    _deadlines.advance(_clock.elapsed(), expired);
+
+    for(QtFirebaseFutureHandle handle : expired) {
+        QtFirebaseFutureRegistry::Entry entry;
+        if(!_futures.take(handle, entry))
+            continue;
+
+        // The future is still pending - receivers report that as a timeout.
+        // If the SDK completes it later the result is simply dropped
+        qCWarning(lcQtFirebase) << self << "::processDeadlines" << "future" << handle << "timed out";
+        recordMetrics(entry, QtFirebaseMetrics::ErrorTimeout);
+        entry.callback(entry.handle, entry.future);
+    }
+
+    if(_deadlines.isEmpty())
+        _deadlineTimer->stop();
+
+    if(_futures.isEmpty())
+        _futureWatchTimer->stop();
 }
 
 QtFirebaseGetInstanceRequest::QtFirebaseGetInstanceRequest():
@@ -188,15 +380,16 @@ void QtFirebaseGetInstanceRequest::exec()
 {
     if(!running())
     {
-        connect(QtFirebase::instance(), &QtFirebase::futureEvent, this, &QtFirebaseGetInstanceRequest::onFutureEvent, Qt::UniqueConnection);
-
         setComplete(false);
 
         firebase::InitResult initResult;
         auto instanceId = firebase::instance_id::InstanceId::GetInstanceId(QtFirebase::instance()->firebaseApp(), &initResult);
         auto getInstanceId = instanceId->GetId();
 
-        QtFirebase::instance()->addFuture("getInstance", getInstanceId);
+        QtFirebase::instance()->addFuture(getInstanceId, this, [this](QtFirebaseFutureHandle handle, const firebase::FutureBase &future) {
+            Q_UNUSED(handle)
+            onFutureEvent(QStringLiteral("getInstance"), future);
+        });
     }
 }
 
@@ -217,16 +410,14 @@ QString QtFirebaseGetInstanceRequest::errorMsg() const
 
 void QtFirebaseGetInstanceRequest::onFutureEvent(QString eventId, firebase::FutureBase future)
 {
-    disconnect(QtFirebase::instance(), &QtFirebase::futureEvent, this, &QtFirebaseGetInstanceRequest::onFutureEvent);
-
     if(future.status() != firebase::kFutureStatusComplete)
     {
-        qDebug() << this << "::onFutureEvent " << "ERROR: Action failed with status: " << future.status();
+        qtfbDebug(lcQtFirebase) << this << "::onFutureEvent " << "ERROR: Action failed with status: " << future.status();
         setError(0);
     }
     else if (future.error() != firebase::instance_id::kErrorNone)
     {
-        qDebug() << this << "::onFutureEvent Error occured in result:" << future.error() << future.error_message();
+        qtfbDebug(lcQtFirebase) << this << "::onFutureEvent Error occured in result:" << future.error() << future.error_message();
         setError(future.error(), future.error_message());
     }
 
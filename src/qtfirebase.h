@@ -7,14 +7,23 @@
 #define qFirebase (static_cast<QtFirebase *>(QtFirebase::instance()))
 
 #include "platformutils.h"
+#include "qtfirebaselogging.h"
+#include "qtfirebasefutureregistry.h"
+#include "qtfirebaseinitscheduler.h"
+#include "qtfirebasemetrics.h"
+#include "qtfirebasetimerwheel.h"
 
 #include "firebase/app.h"
 #include "firebase/future.h"
 #include "firebase/util.h"
 
 #include <QMap>
+#include <QSet>
+#include <QAtomicInt>
 #include <QObject>
+#include <QElapsedTimer>
 #include <QTimer>
+#include <QVariantList>
 #include <QGuiApplication>
 
 class QtFirebase : public QObject
@@ -22,6 +31,9 @@ class QtFirebase : public QObject
     Q_OBJECT
 
     Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
+    Q_PROPERTY(QVariantList startupTimeline READ startupTimeline NOTIFY startupTimelineChanged)
+    // True once the App and every module created so far are ready
+    Q_PROPERTY(bool modulesReady READ modulesReady NOTIFY modulesReadyChanged)
 
 public:
     explicit QtFirebase(QObject* parent = nullptr);
@@ -35,6 +47,7 @@ public:
 
     bool ready() const;
 
+    // NOTE blocks while spinning the event loop, see QtFirebaseFuture for non-blocking adapters
     static void waitForFutureCompletion(firebase::FutureBase future);
     bool checkInstance(const char *function);
 
@@ -42,11 +55,40 @@ public:
     QString instanceId() const;
 
     // TODO make protected and have friend classes?
+    // NOTE the SDK has a single OnCompletion() slot per future, addFuture() takes it over:
+    // a callback set on the future before is replaced. Do not set one afterwards either,
+    // the future would then only be picked up by the (1 s) watch timer
     void addFuture(const QString &eventId, const firebase::FutureBase &future);
+    // A timeout (ms) > 0 sets a deadline. If the future is still pending when it passes,
+    // the callback is called with the pending future and the entry is dropped.
+    // An operation other than None records the latency and outcome in QtFirebaseMetrics
+    QtFirebaseFutureHandle addFuture(const firebase::FutureBase &future, const QtFirebaseFutureRegistry::Callback &callback, int timeout = 0,
+                                     QtFirebaseMetrics::Operation operation = QtFirebaseMetrics::None);
+    QtFirebaseFutureHandle addFuture(const firebase::FutureBase &future, QObject *receiver, const QtFirebaseFutureRegistry::Callback &callback, int timeout = 0,
+                                     QtFirebaseMetrics::Operation operation = QtFirebaseMetrics::None);
+    bool removeFuture(QtFirebaseFutureHandle handle);
+
+    // Futures delivered straight to their receiver, and the slot invocations a futureEvent
+    // broadcast would have cost on top: the other objects with futures registered at the
+    // time of each delivery. Also recorded in QtFirebaseMetrics::dispatch()
+    quint64 routedFutureEvents() const;
+    quint64 savedFutureDispatches() const;
 
     void setOptions(const firebase::AppOptions& options);
+
+    // Startup milestones as a list of { "module": name, "elapsed": ms since QtFirebase was created }
+    QVariantList startupTimeline() const;
+    // Marks a module ready: adds it to the startup timeline and lets the
+    // modules depending on it in the init scheduler start
+    void recordStartup(const QString &module);
+
+    QtFirebaseInitScheduler *initScheduler() const;
+    bool modulesReady() const;
+
 signals:
     void readyChanged();
+    void startupTimelineChanged();
+    void modulesReadyChanged();
 
     void futureEvent(const QString &eventId, firebase::FutureBase future);
 
@@ -54,7 +96,18 @@ public slots:
     void requestInit();
     void processEvents();
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void processDeadlines();
+    void tryInit();
+
 private:
+    void scheduleInit();
+    static void onFutureCompleted(const firebase::FutureBase &future, void *userData);
+    static void recordMetrics(const QtFirebaseFutureRegistry::Entry &entry, int error);
+
     static QtFirebase *self;
     Q_DISABLE_COPY(QtFirebase)
 
@@ -63,9 +116,21 @@ private:
     firebase::AppOptions _appOptions;
 
     QTimer *_initTimer = nullptr;
+    bool _initQueued = false;
+    QtFirebaseInitScheduler *_initScheduler = nullptr;
+    QVariantList _startupTimeline;
 
     QTimer *_futureWatchTimer = nullptr;
-    QMap<QString, firebase::FutureBase> _futureMap;
+    QtFirebaseFutureRegistry _futures;
+    QAtomicInt _processEventsQueued;
+
+    QTimer *_deadlineTimer = nullptr;
+    QtFirebaseTimerWheel _deadlines;
+    QElapsedTimer _clock;
+
+    QSet<QObject *> _futureReceivers;
+    quint64 _routedFutureEvents = 0;
+    quint64 _savedFutureDispatches = 0;
 };
 
 class QtFirebaseGetInstanceRequest: public QObject
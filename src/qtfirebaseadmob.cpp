@@ -17,7 +17,7 @@ QtFirebaseAdMob::QtFirebaseAdMob(QObject* parent) : QObject(parent)
 {
     if(self == 0) {
         self = this;
-        qDebug() << self << "::QtFirebaseAdMob" << "singleton";
+        qtfbDebug(lcQtFirebaseAdMob) << self << "::QtFirebaseAdMob" << "singleton";
     }
 
     _ready = false;
@@ -34,7 +34,7 @@ QtFirebaseAdMob::QtFirebaseAdMob(QObject* parent) : QObject(parent)
 QtFirebaseAdMob::~QtFirebaseAdMob()
 {
     if(_ready) {
-        qDebug() << this << "::~QtFirebaseAdMob" << "shutting down";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::~QtFirebaseAdMob" << "shutting down";
         setReady(false);
         emit shutdown();
         //admob::Terminate(); // TODO causes crash see https://github.com/firebase/quickstart-cpp/issues/19
@@ -46,7 +46,7 @@ bool QtFirebaseAdMob::checkInstance(const char *function) const
 {
     bool b = (QtFirebaseAdMob::self != 0);
     if(!b)
-        qWarning("QtFirebaseAdMob::%s: Please instantiate the QtFirebaseAdMob object first", function);
+        qCWarning(lcQtFirebaseAdMob, "QtFirebaseAdMob::%s: Please instantiate the QtFirebaseAdMob object first", function);
     return b;
 }
 
@@ -59,6 +59,8 @@ void QtFirebaseAdMob::setReady(bool ready)
 {
     if(_ready != ready) {
         _ready = ready;
+        if(_ready)
+            qFirebase->recordStartup(QStringLiteral("QtFirebaseAdMob"));
         emit readyChanged();
     }
 }
@@ -95,24 +97,24 @@ void QtFirebaseAdMob::setTestDevices(const QVariantList &testDevices)
         if(__testDevices == 0)
             __testDevices = new const char*[_testDevices.size()];
         else {
-            qDebug() << this << "::setTestDevices" << "potential crash - not tested";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "potential crash - not tested";
             delete __testDevices;
             __testDevices = new const char*[_testDevices.size()];
-            qDebug() << this << "::setTestDevices" << "survived potential crash!";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "survived potential crash!";
         }
 
         unsigned index = 0;
         for (QVariantList::iterator j = _testDevices.begin(); j != _testDevices.end(); j++)
         {
             //QByteArray ba = QByteArray((*j).toString().toLatin1().data());
-            qDebug() << this << "::setTestDevices" << "adding" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "adding" << (*j).toString();
             __testDevicesByteArrayList.append(QByteArray((*j).toString().toLatin1().data()));
-            qDebug() << this << "::setTestDevices" << "adding to char**" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "adding to char**" << (*j).toString();
             __testDevices[index] = __testDevicesByteArrayList.at(index).constData();
             index++;
         }
 
-        qDebug() << this << "::setTestDevices" << "done";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "done";
 
         emit testDevicesChanged();
     }
@@ -121,7 +123,7 @@ void QtFirebaseAdMob::setTestDevices(const QVariantList &testDevices)
 void QtFirebaseAdMob::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << this << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "base not ready";
         return;
     }
 
@@ -129,7 +131,7 @@ void QtFirebaseAdMob::init()
 
         // Notify the user of the pre-requisity
         if(_appId.isEmpty()) {
-            qWarning() << this << "::init" << "failed to initialize Firebase AdMob." << "No AdMob app ID set";
+            qCWarning(lcQtFirebaseAdMob) << this << "::init" << "failed to initialize Firebase AdMob." << "No AdMob app ID set";
             return;
         }
 
@@ -139,20 +141,20 @@ void QtFirebaseAdMob::init()
         __appId = __appIdByteArray.data();
 
         // Initialize the Firebase AdMob library with AdMob app ID.
-        qDebug() << this << "::init" << "initializing with App ID" << __appId;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initializing with App ID" << __appId;
 
         firebase::App* app = qFirebase->firebaseApp();
         firebase::InitResult ir = admob::Initialize(*app, __appId);
 
-        qDebug() << this << "::init" << "initialized";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initialized";
 
         if(ir != firebase::kInitResultSuccess) {
-            qWarning() << this << "::init" << "failed to initialize Firebase AdMob";
+            qCWarning(lcQtFirebaseAdMob) << this << "::init" << "failed to initialize Firebase AdMob";
             _initializing = false;
             return;
         }
 
-        qDebug() << this << "::init" << "initialized";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initialized";
         _initializing = false;
         setReady(true);
     }
@@ -226,24 +228,24 @@ void QtFirebaseAdMobRequest::setKeywords(const QVariantList &keywords)
         if(__keywords == 0)
             __keywords = new const char*[_keywords.size()];
         else {
-            qDebug() << this << "::setKeywords" << "potential crash - not tested";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setKeywords" << "potential crash - not tested";
             delete __keywords;
             __keywords = new const char*[_keywords.size()];
-            qDebug() << this << "::setKeywords" << "survived potential crash!";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setKeywords" << "survived potential crash!";
         }
 
         unsigned index = 0;
         for (QVariantList::iterator j = _keywords.begin(); j != _keywords.end(); j++)
         {
             //QByteArray ba = QByteArray((*j).toString().toLatin1().data());
-            qDebug() << this << "::setKeywords" << "adding" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setKeywords" << "adding" << (*j).toString();
             __keywordsByteArrayList.append(QByteArray((*j).toString().toLatin1().data()));
-            qDebug() << this << "::setKeywords" << "adding to char**" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setKeywords" << "adding to char**" << (*j).toString();
             __keywords[index] = __keywordsByteArrayList.at(index).constData();
             index++;
         }
 
-        qDebug() << this << "::setKeywords" << "done";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setKeywords" << "done";
 
         emit keywordsChanged();
     }
@@ -264,10 +266,10 @@ void QtFirebaseAdMobRequest::setExtras(const QVariantList &extras)
         if(__extras == 0)
             __extras = new firebase::admob::KeyValuePair[_extras.size()];
         else {
-            qDebug() << this << "::setExtras" << "potential crash - not tested";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setExtras" << "potential crash - not tested";
             delete __extras;
             __extras = new firebase::admob::KeyValuePair[_extras.size()];
-            qDebug() << this << "::setExtras" << "survived potential crash!";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setExtras" << "survived potential crash!";
         }
 
         unsigned index = 0;
@@ -281,14 +283,14 @@ void QtFirebaseAdMobRequest::setExtras(const QVariantList &extras)
                     if(map.first().canConvert<QString>()) {
                         QString key = map.firstKey();
                         QString value = map.first().toString();
-                        qDebug() << this << "::setExtras" << "appending" << key << ":" << value << "to list";
+                        qtfbDebug(lcQtFirebaseAdMob) << this << "::setExtras" << "appending" << key << ":" << value << "to list";
                         __extrasList.append(QPair<QByteArray,QByteArray>(key.toLatin1(),value.toLatin1()));
                         __extras[index] = { __extrasList.at(index).first.constData(), __extrasList.at(index).second.constData() };
                     }
                 }
 
             } else {
-                qWarning() << this << "::setExtras" << "wrong entry in extras list at index" << index;
+                qCWarning(lcQtFirebaseAdMob) << this << "::setExtras" << "wrong entry in extras list at index" << index;
             }
             index++;
         }
@@ -311,24 +313,24 @@ void QtFirebaseAdMobRequest::setTestDevices(QVariantList &testDevices)
         if(__testDevices == 0)
             __testDevices = new const char*[_testDevices.size()];
         else {
-            qDebug() << this << "::setTestDevices" << "potential crash - not tested";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "potential crash - not tested";
             delete __testDevices;
             __testDevices = new const char*[_testDevices.size()];
-            qDebug() << this << "::setTestDevices" << "survived potential crash!";
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "survived potential crash!";
         }
 
         unsigned index = 0;
         for (QVariantList::iterator j = _testDevices.begin(); j != _testDevices.end(); j++)
         {
             //QByteArray ba = QByteArray((*j).toString().toLatin1().data());
-            qDebug() << this << "::setTestDevices" << "adding" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "adding" << (*j).toString();
             __testDevicesByteArrayList.append(QByteArray((*j).toString().toLatin1().data()));
-            qDebug() << this << "::setTestDevices" << "adding to char**" << (*j).toString();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "adding to char**" << (*j).toString();
             __testDevices[index] = __testDevicesByteArrayList.at(index).constData();
             index++;
         }
 
-        qDebug() << this << "::setTestDevices" << "done";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setTestDevices" << "done";
 
         emit testDevicesChanged();
     }
@@ -336,7 +338,7 @@ void QtFirebaseAdMobRequest::setTestDevices(QVariantList &testDevices)
 
 admob::AdRequest QtFirebaseAdMobRequest::asAdMobRequest()
 {
-    qDebug() << this << "::asAdMobRequest";
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest";
 
     // Set some hopefully sane defaults
 
@@ -395,23 +397,23 @@ admob::AdRequest QtFirebaseAdMobRequest::asAdMobRequest()
         _admobRequest.extras = __extras;
 
         // To debug actual extra key:value pairs
-        //qDebug() << this << "::asAdMobRequest" << QString(__extras[1].key) << ":" << QString(__extras[1].value);
+        //qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << QString(__extras[1].key) << ":" << QString(__extras[1].value);
     }
 
-    qDebug() << this << "::asAdMobRequest" << "Gender" << _gender;
-    qDebug() << this << "::asAdMobRequest" << "Child directed treatment" << _childDirectedTreatment;
-    qDebug() << this << "::asAdMobRequest" << "Birthday" << _birthday;
-    qDebug() << this << "::asAdMobRequest" << "Keywords" << _keywords;
-    qDebug() << this << "::asAdMobRequest" << "Extras" << _extras;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "Gender" << _gender;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "Child directed treatment" << _childDirectedTreatment;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "Birthday" << _birthday;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "Keywords" << _keywords;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "Extras" << _extras;
 
     // NOTE if no test devices are provided - use list from QtFirebaseAdMob singleton if not empty
     if(!_testDevices.isEmpty()) {
-        qDebug() << this << "::asAdMobRequest" << "TestDevices" << _testDevices;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "TestDevices" << _testDevices;
         _admobRequest.test_device_id_count = __testDevicesByteArrayList.size();
         _admobRequest.test_device_ids = __testDevices;
     } else {
         if(qFirebaseAdMob->ready()) {
-            qDebug() << this << "::asAdMobRequest" << "TestDevices ( from" << qFirebaseAdMob << ")" << qFirebaseAdMob->testDevices();
+            qtfbDebug(lcQtFirebaseAdMob) << this << "::asAdMobRequest" << "TestDevices ( from" << qFirebaseAdMob << ")" << qFirebaseAdMob->testDevices();
             _admobRequest.test_device_id_count = qFirebaseAdMob->__testDevicesByteArrayList.size();
             _admobRequest.test_device_ids = qFirebaseAdMob->__testDevices;
         }
@@ -445,7 +447,7 @@ QtFirebaseAdMobBase::QtFirebaseAdMobBase(QObject *parent) : QObject(parent) {
 QtFirebaseAdMobBase::~QtFirebaseAdMobBase()
 {
     if(_ready) {
-        qDebug() << this << "::~QtFirebaseAdMobBase" << "shutting down";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::~QtFirebaseAdMobBase" << "shutting down";
         setReady(false);
     }
 }
@@ -507,33 +509,33 @@ void QtFirebaseAdMobBase::setRequest(QtFirebaseAdMobRequest *request) {
 void QtFirebaseAdMobBase::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << this << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "base not ready";
         return;
     }
 
     if(!qFirebaseAdMob->ready()) {
-        qDebug() << this << "::init" << "AdMob base not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "AdMob base not ready";
         return;
     }
 
     if(_adUnitId.isEmpty()) {
-        qDebug() << this << "::init" << "adUnitId must be set in order to initialize";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "adUnitId must be set in order to initialize";
         return;
     }
 
     if(_isFirstInit && !PlatformUtils::getNativeWindow()) {
-        qDebug() << this << "::init" << "no native ui element. Waiting for it...";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "no native ui element. Waiting for it...";
         return;
     }
 
     // TODO test if this actually nessecary anymore
     if(!_nativeUIElement && !PlatformUtils::getNativeWindow()) {
-        qDebug() << this << "::init" << "no native ui element";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "no native ui element";
         return;
     }
 
     if(!_nativeUIElement && PlatformUtils::getNativeWindow()) {
-        qDebug() << this << "::init" << "setting native ui element";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "setting native ui element";
         _nativeUIElement = PlatformUtils::getNativeWindow();
     }   
 
@@ -551,12 +553,12 @@ void QtFirebaseAdMobBase::init()
                 QMetaObject::invokeMethod(this, [this, completed_future]() {
                 #endif
                     if(completed_future.error() != admob::kAdMobErrorNone) {
-                        qDebug() << this << "::init" << "initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
+                        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
                         emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
                         _initializing = false;
                     }
                     else {
-                        qDebug() << this << "::init" << "initialized";
+                        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initialized";
                         _initializing = false;
                         _isFirstInit = false;
                         onInitialized();
@@ -573,16 +575,16 @@ void QtFirebaseAdMobBase::init()
 void QtFirebaseAdMobBase::load()
 {
     if(!_ready) {
-        qDebug() << this << "::load" << "not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::load" << "not ready";
         return;
     }
 
     if(_request == 0) {
-        qDebug() << this << "::load() no request data sat. Not loading";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::load() no request data sat. Not loading";
         return;
     }
 
-    qDebug() << this << "::load() getting request data";
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::load() getting request data";
     setLoaded(false);
     emit loading();
     firebase::FutureBase future = loadInternal();
@@ -594,11 +596,11 @@ void QtFirebaseAdMobBase::load()
         QMetaObject::invokeMethod(this, [this, completed_future]() {
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone) {
-                qWarning() << this << "::load" << "load failed" << "ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
+                qCWarning(lcQtFirebaseAdMob) << this << "::load" << "load failed" << "ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
             }
             else {
-                qDebug() << this << "::load loaded";
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::load loaded";
                 setLoaded(true);
             }
         #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
@@ -654,7 +656,7 @@ void QtFirebaseAdMobBannerBase::setHeight(int height) {
 void QtFirebaseAdMobBannerBase::moveTo(int x, int y)
 {
     if(_ready) {
-        qDebug() << this << "::moveTo moving to" << x << "," << y;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo moving to" << x << "," << y;
         auto future = moveToInternal(x, y);
 
         future.OnCompletion([this, x, y](const firebase::FutureBase& completed_future)
@@ -664,7 +666,7 @@ void QtFirebaseAdMobBannerBase::moveTo(int x, int y)
             QMetaObject::invokeMethod(this, [this, completed_future, x, y]() {
             #endif
                 if(completed_future.error() != admob::kAdMobErrorNone) {
-                    qWarning() << this << "::moveTo " << x << " x " << y << " ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
+                    qCWarning(lcQtFirebaseAdMob) << this << "::moveTo " << x << " x " << y << " ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
                     emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
                 }
                 else {
@@ -677,7 +679,7 @@ void QtFirebaseAdMobBannerBase::moveTo(int x, int y)
                         _y = y;
                         emit yChanged();
                     }
-                    qDebug() << this << "::moveTo moved to" << x << "," << y;
+                    qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo moved to" << x << "," << y;
                 }
             #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
             });
@@ -689,7 +691,7 @@ void QtFirebaseAdMobBannerBase::moveTo(int x, int y)
 void QtFirebaseAdMobBannerBase::moveTo(Position position)
 {
     if(!_ready) {
-        qDebug() << this << "::moveTo" << "not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo" << "not ready";
         return;
     }
 
@@ -701,11 +703,11 @@ void QtFirebaseAdMobBannerBase::moveTo(Position position)
         QMetaObject::invokeMethod(this, [this, completed_future, position]() {
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone) {
-                qWarning() << this << "::moveTo " << position << " ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
+                qCWarning(lcQtFirebaseAdMob) << this << "::moveTo " << position << " ERROR" << "code:" << completed_future.error() << "message:" << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
             }
             else {
-                qDebug() << this << "::moveTo moved to" << position;
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo moved to" << position;
             }
         #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
         });
@@ -716,12 +718,12 @@ void QtFirebaseAdMobBannerBase::moveTo(Position position)
 void QtFirebaseAdMobBannerBase::setVisible(bool visible)
 {
     if(!_ready) {
-        qDebug() << this << "::setVisible native part not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not ready";
         return;
     }
 
     if(!_loaded) {
-        qDebug() << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
         return;
     }
 
@@ -734,11 +736,11 @@ void QtFirebaseAdMobBannerBase::setVisible(bool visible)
             QMetaObject::invokeMethod(this, [this, completed_future, visible]() {
             #endif
                 if(completed_future.error() != admob::kAdMobErrorNone) {
-                    qDebug() << this << "::setVisible" << visible <<  " ERROR code" << completed_future.error() << "message" << completed_future.error_message();
+                    qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible" << visible <<  " ERROR code" << completed_future.error() << "message" << completed_future.error_message();
                     emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
                 }
                 else {
-                    qDebug() << this << "::setVisible(" << visible << ")";
+                    qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible(" << visible << ")";
 
                     _visible = visible;
                     emit visibleChanged();
@@ -768,7 +770,7 @@ void QtFirebaseAdMobBannerBase::onApplicationStateChanged(Qt::ApplicationState s
 {
     // NOTE makes sure the ad banner is on top of the Qt surface
 #if defined(Q_OS_ANDROID) && !defined(QTFIREBASE_DISABLE_FIX_ANDROID_AUTO_APP_STATE_VISIBILTY)
-    qDebug() << this << "::onApplicationStateChanged" << "Applying visibility fix";
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::onApplicationStateChanged" << "Applying visibility fix";
     if(state != Qt::ApplicationActive)
         hide();
     else
@@ -807,7 +809,7 @@ QtFirebaseAdMobBanner::~QtFirebaseAdMobBanner()
 
         _banner->Destroy();
         qFirebase->waitForFutureCompletion(_banner->DestroyLastResult()); // TODO MAYBE move or duplicate to QtFirebaseAdMob with admob::kAdMobError* checking? (Will save ALOT of cycles on errors)
-        qDebug() << this << "::~QtFirebaseAdMobBanner" << "Destroyed banner";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::~QtFirebaseAdMobBanner" << "Destroyed banner";
 
         delete _banner;
     }
@@ -850,7 +852,7 @@ firebase::FutureBase QtFirebaseAdMobBanner::initInternal()
 
     // A reference to an iOS UIView or an Android Activity.
     // This is the parent UIView or Activity of the banner view.
-    qDebug() << this << "::init initializing with AdUnitID" << __adUnitIdByteArray.constData();
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::init initializing with AdUnitID" << __adUnitIdByteArray.constData();
     return _banner->Initialize(static_cast<admob::AdParent>(_nativeUIElement), __adUnitIdByteArray.constData(), ad_size);
 }
 
@@ -869,26 +871,26 @@ firebase::FutureBase QtFirebaseAdMobBanner::moveToInternal(Position position)
 {
     switch (position) {
     case PositionTopCenter:
-        qDebug() << this << "::moveTo position top-center";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position top-center";
         return _banner->MoveTo(admob::BannerView::kPositionTop);
     case PositionTopLeft:
-        qDebug() << this << "::moveTo position top-left";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position top-left";
         return _banner->MoveTo(admob::BannerView::kPositionTopLeft);
     case PositionTopRight:
-        qDebug() << this << "::moveTo position top-right";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position top-right";
         return _banner->MoveTo(admob::BannerView::kPositionTopRight);
     case PositionBottomCenter:
-        qDebug() << this << "::moveTo position bottom-center";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position bottom-center";
         return _banner->MoveTo(admob::BannerView::kPositionBottom);
     case PositionBottomLeft:
-        qDebug() << this << "::moveTo position bottom-left";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position bottom-left";
         return _banner->MoveTo(admob::BannerView::kPositionBottomLeft);
     case PositionBottomRight:
-        qDebug() << this << "::moveTo position bottom-right";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position bottom-right";
         return _banner->MoveTo(admob::BannerView::kPositionBottomRight);
     }
 
-    qDebug() << this << "::moveTo position unknown" << position;
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::moveTo position unknown" << position;
     return firebase::FutureBase();
 }
 
@@ -908,7 +910,7 @@ QtFirebaseAdMobInterstitial::~QtFirebaseAdMobInterstitial()
         _interstitial->SetListener(nullptr);
         delete _interstitialAdListener;
 
-        qDebug() << this << "::~QtFirebaseAdMobInterstitial" << "Destroyed Interstitial";        
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::~QtFirebaseAdMobInterstitial" << "Destroyed Interstitial";        
         delete _interstitial;
     }
 
@@ -919,12 +921,12 @@ QtFirebaseAdMobInterstitial::~QtFirebaseAdMobInterstitial()
 void QtFirebaseAdMobInterstitial::setVisible(bool visible)
 {
     if(!_ready) {
-        qDebug() << this << "::setVisible native part not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not ready";
         return;
     }
 
     if(!_loaded) {
-        qDebug() << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
         return;
     }
 
@@ -932,7 +934,7 @@ void QtFirebaseAdMobInterstitial::setVisible(bool visible)
         show(); // NOTE show will change _visible and emit signal
     } else {
         // NOTE An interstitial can't be hidden by any other than the user
-        qInfo() << this << "::setVisible" << visible << " - interstitials can't be hidden programmatically. Not hidding";
+        qCInfo(lcQtFirebaseAdMob) << this << "::setVisible" << visible << " - interstitials can't be hidden programmatically. Not hidding";
     }
 }
 
@@ -945,7 +947,7 @@ firebase::FutureBase QtFirebaseAdMobInterstitial::initInternal()
 
     // A reference to an iOS UIView or an Android Activity.
     // This is the parent UIView or Activity of the Interstitial view.
-    qDebug() << this << "::init initializing with AdUnitID" << __adUnitIdByteArray.constData();
+    qtfbDebug(lcQtFirebaseAdMob) << this << "::init initializing with AdUnitID" << __adUnitIdByteArray.constData();
     auto future = _interstitial->Initialize(static_cast<admob::AdParent>(_nativeUIElement), __adUnitIdByteArray.constData());
     future.OnCompletion([this](const firebase::FutureBase& completed_future)
     {
@@ -954,7 +956,7 @@ firebase::FutureBase QtFirebaseAdMobInterstitial::initInternal()
         QMetaObject::invokeMethod(this, [this, completed_future]() {
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone) {
-                qDebug() << this << "::init" << "initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
                 _initializing = false;
             } else {
@@ -962,7 +964,7 @@ firebase::FutureBase QtFirebaseAdMobInterstitial::initInternal()
                 // NOTE don't delete it as we need it on iOS to re-initalize the whole mill after every load and show
                 //delete _initTimer;
 
-                qDebug() << this << "::init initialized";
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::init initialized";
                 _initializing = false;
                 _isFirstInit = false;
 
@@ -1000,19 +1002,19 @@ void QtFirebaseAdMobInterstitial::onPresentationStateChanged(int state)
         }
 
         setLoaded(false);
-        qDebug() << this << "::onPresentationStateChanged() loaded false";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() loaded false";
 
         // NOTE iOS necessities
 #if defined(Q_OS_IOS)
 
         setReady(false);
-        qDebug() << this << "::onPresentationStateChanged() ready false";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() ready false";
 
         // Will be newed when init() is called
         //delete _interstitial; // NOTE Crashes the app when used
 
         // NOTE Auto re-initializing because of this: https://firebase.google.com/docs/admob/ios/interstitial#only_show_gadinterstitial_once
-        qDebug() << this << "::onPresentationStateChanged() re-initializing one-time use GADInterstitial";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() re-initializing one-time use GADInterstitial";
         _initTimer->start(500);
 
 #endif
@@ -1030,12 +1032,12 @@ firebase::FutureBase QtFirebaseAdMobInterstitial::loadInternal()
 void QtFirebaseAdMobInterstitial::show()
 {
     if(!_ready) {
-        qDebug() << this << "::show" << "not ready - so not showing";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::show" << "not ready - so not showing";
         return;
     }
 
     if(!_loaded) {
-        qDebug() << this << "::show" << "not loaded - so not showing";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::show" << "not loaded - so not showing";
         return;
     }
 
@@ -1047,7 +1049,7 @@ void QtFirebaseAdMobInterstitial::show()
         QMetaObject::invokeMethod(this, [this, completed_future]() {
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone) {
-                qDebug() << this << "::show" << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::show" << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
             }
         #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
@@ -1070,7 +1072,7 @@ QtFirebaseAdMobRewardedVideoAd::~QtFirebaseAdMobRewardedVideoAd()
 {
     if(_ready) {
         firebase::admob::rewarded_video::Destroy();
-        qDebug() << this << "::~QtFirebaseAdMobRewardedVideoAd" << "Destroyed";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::~QtFirebaseAdMobRewardedVideoAd" << "Destroyed";
     }
     _initTimer->stop();
 }
@@ -1078,12 +1080,12 @@ QtFirebaseAdMobRewardedVideoAd::~QtFirebaseAdMobRewardedVideoAd()
 void QtFirebaseAdMobRewardedVideoAd::setVisible(bool visible)
 {
     if(!_ready) {
-        qDebug() << this << "::setVisible native part not ready";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not ready";
         return;
     }
 
     if(!_loaded) {
-        qDebug() << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::setVisible native part not loaded - so not changing visiblity to" << visible;
         return;
     }
 
@@ -1091,7 +1093,7 @@ void QtFirebaseAdMobRewardedVideoAd::setVisible(bool visible)
         show(); // NOTE show will change _visible and emit signal
     } else {
         // NOTE An interstitial can't be hidden by any other than the user
-        qInfo() << this << "::setVisible" << visible << " - interstitials can't be hidden programmatically. Not hidding";
+        qCInfo(lcQtFirebaseAdMob) << this << "::setVisible" << visible << " - interstitials can't be hidden programmatically. Not hidding";
     }
 }
 
@@ -1107,14 +1109,14 @@ firebase::FutureBase QtFirebaseAdMobRewardedVideoAd::initInternal()
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone)
             {
-                qDebug() << this << "::init initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::init initializing failed." << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
                 _initializing = false;
             }
             else
             {
                 _initTimer->stop();
-                qDebug() << this << "::init initialized";
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::init initialized";
                 _initializing = false;
                 _isFirstInit = false;
                 firebase::admob::rewarded_video::SetListener(this);
@@ -1145,19 +1147,19 @@ void QtFirebaseAdMobRewardedVideoAd::onPresentationStateChanged(int state)
         }
 
         setLoaded(false);
-        qDebug() << this << "::onPresentationStateChanged() loaded false";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() loaded false";
 
         // NOTE iOS necessities
         /*#if defined(Q_OS_IOS)
 
         setReady(false);
-        qDebug() << this << "::onPresentationStateChanged() ready false";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() ready false";
 
         // Will be newed when init() is called
         //delete _interstitial; // NOTE Crashes the app when used
 
         // NOTE Auto re-initializing because of this: https://firebase.google.com/docs/admob/ios/interstitial#only_show_gadinterstitial_once
-        qDebug() << this << "::onPresentationStateChanged() re-initializing one-time use GADInterstitial";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::onPresentationStateChanged() re-initializing one-time use GADInterstitial";
         _initTimer->start(500);
 
         #endif*/
@@ -1177,22 +1179,22 @@ firebase::FutureBase QtFirebaseAdMobRewardedVideoAd::loadInternal()
 void QtFirebaseAdMobRewardedVideoAd::show()
 {
     if(!_ready) {
-        qDebug() << this << "::show() not ready - so not showing";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::show() not ready - so not showing";
         return;
     }
 
     if(!_loaded) {
-        qDebug() << this << "::show() not loaded - so not showing";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::show() not loaded - so not showing";
         return;
     }
 
     if(!_nativeUIElement && !PlatformUtils::getNativeWindow()) {
-        qDebug() << this << "::init" << "no native ui element";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "no native ui element";
         return;
     }
 
     if(!_nativeUIElement && PlatformUtils::getNativeWindow()) {
-        qDebug() << this << "::init" << "setting native ui element";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "::init" << "setting native ui element";
         _nativeUIElement = PlatformUtils::getNativeWindow();
     }
 
@@ -1206,7 +1208,7 @@ void QtFirebaseAdMobRewardedVideoAd::show()
         #endif
             if(completed_future.error() != admob::kAdMobErrorNone)
             {
-                qDebug() << this << "::show " << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
+                qtfbDebug(lcQtFirebaseAdMob) << this << "::show " << "ERROR: Action failed with error code and message: " << completed_future.error() << completed_future.error_message();
                 emit error(completed_future.error(), QString(QString::fromUtf8(completed_future.error_message())));
             }
         #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
@@ -1218,7 +1220,7 @@ void QtFirebaseAdMobRewardedVideoAd::show()
 void QtFirebaseAdMobRewardedVideoAd::OnRewarded(firebase::admob::rewarded_video::RewardItem reward)
 {
     QString type = QString::fromStdString(reward.reward_type);
-    qDebug() << this << QString(QStringLiteral("Rewarding user of %1 with amount %2")).arg(type).arg(QString::number(reward.amount));
+    qtfbDebug(lcQtFirebaseAdMob) << this << QString(QStringLiteral("Rewarding user of %1 with amount %2")).arg(type).arg(QString::number(reward.amount));
 
     emit rewarded(type, reward.amount);
 }
@@ -1227,15 +1229,15 @@ void QtFirebaseAdMobRewardedVideoAd::OnPresentationStateChanged(firebase::admob:
 {
     if(state == firebase::admob::rewarded_video::kPresentationStateHidden)
     {
-        qDebug() << this << "kPresentationStateHidden";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "kPresentationStateHidden";
     }
     else if(state == firebase::admob::rewarded_video::kPresentationStateCoveringUI)
     {
-        qDebug() << this << "kPresentationStateCoveringUI";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "kPresentationStateCoveringUI";
     }
     else if(state == firebase::admob::rewarded_video::kPresentationStateVideoHasStarted)
     {
-        qDebug() << this << "kPresentationStateVideoHasStarted";
+        qtfbDebug(lcQtFirebaseAdMob) << this << "kPresentationStateVideoHasStarted";
     }
 
     int pState = QtFirebaseAdMobInterstitial::PresentationStateHidden;
@@ -81,7 +81,7 @@ public:
     static QtFirebaseAdMob *instance() {
         if(self == 0) {
             self = new QtFirebaseAdMob(0);
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseAdMob) << self << "::instance" << "singleton";
         }
         return self;
     }
@@ -432,27 +432,27 @@ public:
 
     void OnPresentationStateChanged(firebase::admob::BannerView* banner_view, firebase::admob::BannerView::PresentationState state) override {
         Q_UNUSED(banner_view); // TODO
-        qDebug() << _qtFirebaseAdMobBanner << "::OnPresentationStateChanged";
-        qDebug("BannerView PresentationState has changed to %d.", state);
+        qtfbDebug(lcQtFirebaseAdMob) << _qtFirebaseAdMobBanner << "::OnPresentationStateChanged";
+        qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to" << state;
 
         switch(state) {
             case firebase::admob::BannerView::kPresentationStateHidden:
-                qDebug("BannerView PresentationState has changed to kPresentationStateHidden");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to kPresentationStateHidden";
                 break;
             case firebase::admob::BannerView::kPresentationStateVisibleWithoutAd:
-                qDebug("BannerView PresentationState has changed to PresentationStateVisibleWithoutAd");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to PresentationStateVisibleWithoutAd";
                 break;
             case firebase::admob::BannerView::kPresentationStateVisibleWithAd:
-                qDebug("BannerView PresentationState has changed to PresentationStateVisibleWithAd");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to PresentationStateVisibleWithAd";
                 break;
             case firebase::admob::BannerView::kPresentationStateOpenedPartialOverlay:
-                qDebug("BannerView PresentationState has changed to PresentationStateOpenedPartialOverlay");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to PresentationStateOpenedPartialOverlay";
                 break;
             case firebase::admob::BannerView::kPresentationStateCoveringUI:
-                qDebug("BannerView PresentationState has changed to PresentationStateCoveringUI");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to PresentationStateCoveringUI";
                 break;
             default:
-                qDebug("BannerView PresentationState has changed to Unknown");
+                qtfbDebug(lcQtFirebaseAdMob) << "BannerView PresentationState has changed to Unknown";
         }
 
         QMetaObject::invokeMethod(_qtFirebaseAdMobBanner, [this, state]() {
@@ -462,9 +462,9 @@ public:
 
     void OnBoundingBoxChanged(firebase::admob::BannerView *banner_view, firebase::admob::BoundingBox box) override {
         Q_UNUSED(banner_view); // TODO
-        qDebug() << _qtFirebaseAdMobBanner << "::OnBoundingBoxChanged";
+        qtfbDebug(lcQtFirebaseAdMob) << _qtFirebaseAdMobBanner << "::OnBoundingBoxChanged";
         QRect boundingBox(box.x, box.y, box.width, box.height);
-        qDebug() << "BannerView BoundingBox has changed to" << boundingBox;
+        qtfbDebug(lcQtFirebaseAdMob) << "BannerView BoundingBox has changed to" << boundingBox;
 
         QMetaObject::invokeMethod(_qtFirebaseAdMobBanner, [this, boundingBox]() {
             _qtFirebaseAdMobBanner->setBoundingBox(boundingBox);
@@ -531,8 +531,8 @@ public:
     void OnPresentationStateChanged(firebase::admob::InterstitialAd* interstitial_ad,
         firebase::admob::InterstitialAd::PresentationState state) override {
         Q_UNUSED(interstitial_ad); // TODO
-        qDebug() << _qtFirebaseAdMobInterstitial << "::OnPresentationStateChanged";
-        qDebug("InterstitialAd PresentationState has changed to %d.", state);
+        qtfbDebug(lcQtFirebaseAdMob) << _qtFirebaseAdMobInterstitial << "::OnPresentationStateChanged";
+        qtfbDebug(lcQtFirebaseAdMob) << "InterstitialAd PresentationState has changed to" << state;
 
         int pState = QtFirebaseAdMobInterstitial::PresentationStateHidden;
 
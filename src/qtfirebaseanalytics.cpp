@@ -1,4 +1,5 @@
 #include "qtfirebaseanalytics.h"
+#include "qtfirebasearena.h"
 
 #include <QGuiApplication>
 
@@ -10,24 +11,23 @@ QtFirebaseAnalytics::QtFirebaseAnalytics(QObject* parent) : QObject(parent)
 {
     if(!self) {
         self = this;
-        qDebug() << self << "::QtFirebaseAnalytics" << "singleton";
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::QtFirebaseAnalytics" << "singleton";
     }
 
     _ready = false;
     _initializing = false;
 
-    if(qFirebase->ready())
-        init();
-    else {
-        connect(qFirebase,&QtFirebase::readyChanged, this, &QtFirebaseAnalytics::init);
+    // Initialize uses the Activity / main run loop, keep it on the GUI thread
+    qFirebase->initScheduler()->addModule(QStringLiteral("QtFirebaseAnalytics"), QtFirebaseInitScheduler::GuiThread,
+                                          QtFirebaseInitScheduler::Work(), this, [this]() { init(); });
+    if(!qFirebase->ready())
         qFirebase->requestInit();
-    }
 }
 
 QtFirebaseAnalytics::~QtFirebaseAnalytics()
 {
     if(_ready) {
-        qDebug() << self << "::~QtFirebaseAnalytics" << "shutting down";
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::~QtFirebaseAnalytics" << "shutting down";
         analytics::Terminate();
         _ready = false;
         self = nullptr;
@@ -38,119 +38,111 @@ bool QtFirebaseAnalytics::checkInstance(const char *function)
 {
     bool b = (QtFirebaseAnalytics::self != nullptr);
     if (!b)
-        qWarning("QtFirebaseAnalytics::%s: Please instantiate the QtFirebaseAnalytics object first", function);
+        qCWarning(lcQtFirebaseAnalytics, "QtFirebaseAnalytics::%s: Please instantiate the QtFirebaseAnalytics object first", function);
     return b;
 }
 
 void QtFirebaseAnalytics::setUserProperty(const QString &propertyName, const QString &propertyValue)
 {
     if(!_ready) {
-        qDebug() << this << "::setUserProperty native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setUserProperty native part not ready";
         return;
     }
 
-    qDebug() << this << "::setUserProperty" << propertyName << ":" << propertyValue;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::setUserProperty" << propertyName << ":" << propertyValue;
     analytics::SetUserProperty(propertyName.toLatin1().constData(), propertyValue.toLatin1().constData());
 }
 
 void QtFirebaseAnalytics::setCurrentScreen(const QString &screenName, const QString &screenClass)
 {
     if(!_ready) {
-        qDebug() << this << "::setCurrentScreen native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setCurrentScreen native part not ready";
         return;
     }
 
-    qDebug() << this << "::setCurrentScreen" << screenName << ":" << screenClass ;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::setCurrentScreen" << screenName << ":" << screenClass ;
     analytics::SetCurrentScreen(screenName.toLatin1().constData(), screenClass.toLatin1().constData());
 }
 
 void QtFirebaseAnalytics::logEvent(const QString &name)
 {
     if(!_ready) {
-        qDebug() << this << "::logEvent native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent native part not ready";
         return;
     }
 
-    qDebug() << this << "::logEvent" << name << "logging (no parameters)";
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << name << "logging (no parameters)";
     analytics::LogEvent(name.toUtf8().constData());
 }
 
 void QtFirebaseAnalytics::logEvent(const QString &name, const QString &parameterName, const QString &parameterValue)
 {
     if(!_ready) {
-        qDebug() << this << "::logEvent native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent native part not ready";
         return;
     }
 
-    qDebug() << this << "::logEvent" << name << "logging string parameter" << parameterName << ":" << parameterValue;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << name << "logging string parameter" << parameterName << ":" << parameterValue;
     analytics::LogEvent(name.toUtf8().constData(), parameterName.toUtf8().constData(),parameterValue.toUtf8().constData());
 }
 
 void QtFirebaseAnalytics::logEvent(const QString &name, const QString &parameterName, const double parameterValue)
 {
     if(!_ready) {
-        qDebug() << this << "::logEvent native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent native part not ready";
         return;
     }
 
-    qDebug() << this << "::logEvent" << name << "logging double parameter" << parameterName << ":" << parameterValue;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << name << "logging double parameter" << parameterName << ":" << parameterValue;
     analytics::LogEvent(name.toUtf8().constData(), parameterName.toUtf8().constData(),parameterValue);
 }
 
 void QtFirebaseAnalytics::logEvent(const QString &name, const QString &parameterName, const int parameterValue)
 {
     if(!_ready) {
-        qDebug() << this << "::logEvent native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent native part not ready";
         return;
     }
 
-    qDebug() << this << "::logEvent" << name << "logging int parameter" << parameterName << ":" << parameterValue;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << name << "logging int parameter" << parameterName << ":" << parameterValue;
     analytics::LogEvent(name.toUtf8().constData(), parameterName.toUtf8().constData(),parameterValue);
 }
 
 void QtFirebaseAnalytics::logEvent(const QString &name, const QVariantMap &bundle)
 {
     if(!_ready) {
-        qDebug() << this << "::logEvent native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent native part not ready";
         return;
     }
 
-    analytics::Parameter *parameters = new analytics::Parameter[bundle.size()];
-
-    QByteArrayList keys;
-    QByteArrayList strings;
+    // Keys, strings and the parameter array only have to live until LogEvent returns
+    QtFirebaseArena arena;
+    analytics::Parameter *parameters = arena.create<analytics::Parameter>(static_cast<size_t>(bundle.size()));
 
-    QMapIterator<QString, QVariant> i(bundle);
     int index = 0;
-    while (i.hasNext()) {
-        i.next();
-
-        keys.append(i.key().toUtf8());
-        QString eventKey = i.key();
-        QVariant variant = i.value();
+    for(QVariantMap::const_iterator it = bundle.constBegin(); it != bundle.constEnd(); ++it, ++index) {
+        const QString &eventKey = it.key();
+        const QVariant &variant = it.value();
+        const char *key = arena.utf8(eventKey);
 
         if(variant.type() == QVariant::Type(QMetaType::Int)) {
-            parameters[index] = analytics::Parameter(keys.at(index).constData(), variant.toInt());
-            qDebug() << this << "::logEvent" << "bundle parameter" << eventKey << ":" << variant.toInt();
+            parameters[index] = analytics::Parameter(key, variant.toInt());
+            qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << "bundle parameter" << eventKey << ":" << variant.toInt();
         } else if(variant.type() == QVariant::Type(QMetaType::Double)) {
-            parameters[index] = analytics::Parameter(keys.at(index).constData(),variant.toDouble());
-            qDebug() << this << "::logEvent" << "bundle parameter" << eventKey << ":" << variant.toDouble();
+            parameters[index] = analytics::Parameter(key, variant.toDouble());
+            qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << "bundle parameter" << eventKey << ":" << variant.toDouble();
         } else if(variant.type() == QVariant::Type(QMetaType::QString)) {
-            strings.append(variant.toString().toUtf8());
-            parameters[index] = analytics::Parameter(keys.at(index).constData(), strings.at(strings.size()-1).constData());
-            qDebug() << this << "::logEvent" << "bundle parameter" << eventKey << ":" << strings.at(strings.size()-1);
+            const char *value = arena.utf8(variant.toString());
+            parameters[index] = analytics::Parameter(key, value);
+            qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << "bundle parameter" << eventKey << ":" << value;
         } else {
-            qWarning() << this << "::logEvent" << "bundle parameter" << eventKey << "has unsupported data type. Sending empty strings";
+            qCWarning(lcQtFirebaseAnalytics) << this << "::logEvent" << "bundle parameter" << eventKey << "has unsupported data type. Sending empty strings";
             parameters[index] = analytics::Parameter("", "");
         }
-
-        index++;
     }
 
-    qDebug() << this << "::logEvent" << "logging" << "bundle" << name;
-    analytics::LogEvent(name.toUtf8().constData(), parameters, static_cast<size_t>(bundle.size()));
-    delete[] parameters;
-    parameters = nullptr;
+    qtfbDebug(lcQtFirebaseAnalytics) << this << "::logEvent" << "logging" << "bundle" << name;
+    analytics::LogEvent(arena.utf8(name), parameters, static_cast<size_t>(bundle.size()));
 }
 
 QVariantList QtFirebaseAnalytics::userProperties() const
@@ -161,7 +153,7 @@ QVariantList QtFirebaseAnalytics::userProperties() const
 void QtFirebaseAnalytics::setUserProperties(const QVariantList &userProperties)
 {
     if(!_ready) {
-        qDebug() << this << "::setUserProperties native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setUserProperties native part not ready";
         return;
     }
 
@@ -188,7 +180,7 @@ void QtFirebaseAnalytics::setUserProperties(const QVariantList &userProperties)
                 }
 
             } else {
-                qWarning() << this << "::setUserProperties" << "wrong entry in userProperties list at index" << index;
+                qCWarning(lcQtFirebaseAnalytics) << this << "::setUserProperties" << "wrong entry in userProperties list at index" << index;
             }
             index++;
         }
@@ -204,7 +196,7 @@ QString QtFirebaseAnalytics::userId() const
 void QtFirebaseAnalytics::setUserId(const QString &userId)
 {
     if(!_ready) {
-        qDebug() << this << "::setUserId native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setUserId native part not ready";
         return;
     }
 
@@ -214,12 +206,12 @@ void QtFirebaseAnalytics::setUserId(const QString &userId)
     }
     if(aUserId.length() > 36) {
         aUserId = aUserId.left(36);
-        qWarning() << this << "::setUserId" << "ID longer than allowed 36 chars" << "TRUNCATED to" << aUserId;
+        qCWarning(lcQtFirebaseAnalytics) << this << "::setUserId" << "ID longer than allowed 36 chars" << "TRUNCATED to" << aUserId;
     }
     if(_userId != aUserId) {
         _userId = aUserId;
         analytics::SetUserId(_userId.toLatin1().constData());
-        qDebug() << this << "::setUserId sat to" << _userId;
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setUserId sat to" << _userId;
         emit userIdChanged();
     }
 }
@@ -227,7 +219,7 @@ void QtFirebaseAnalytics::setUserId(const QString &userId)
 void QtFirebaseAnalytics::unsetUserId()
 {
     if(!_ready) {
-        qDebug() << this << "::unsetUserId native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::unsetUserId native part not ready";
         return;
     }
 
@@ -260,7 +252,9 @@ void QtFirebaseAnalytics::setReady(bool ready)
 {
     if (_ready != ready) {
         _ready = ready;
-        qDebug() << self << "::setReady" << ready;
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::setReady" << ready;
+        if(_ready)
+            qFirebase->recordStartup(QStringLiteral("QtFirebaseAnalytics"));
         emit readyChanged();
     }
 }
@@ -273,14 +267,14 @@ bool QtFirebaseAnalytics::enabled()
 void QtFirebaseAnalytics::setEnabled(bool enabled)
 {
     if(!_ready) {
-        qDebug() << this << "::setEnabled native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setEnabled native part not ready";
         return;
     }
 
     if (_enabled != enabled) {
         analytics::SetAnalyticsCollectionEnabled(enabled);
         _enabled = enabled;
-        qDebug() << self << "::setEnabled" << enabled;
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::setEnabled" << enabled;
         emit enabledChanged();
     }
 }
@@ -293,14 +287,14 @@ unsigned int QtFirebaseAnalytics::minimumSessionDuration()
 void QtFirebaseAnalytics::setMinimumSessionDuration(unsigned int minimumSessionDuration)
 {
     if(!_ready) {
-        qDebug() << this << "::setMinimumSessionDuration native part not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << this << "::setMinimumSessionDuration native part not ready";
         return;
     }
 
     if (_minimumSessionDuration != minimumSessionDuration) {
         analytics::SetMinimumSessionDuration(minimumSessionDuration);
         _minimumSessionDuration = minimumSessionDuration;
-        qDebug() << self << "::setMinimumSessionDuration" << minimumSessionDuration;
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::setMinimumSessionDuration" << minimumSessionDuration;
         emit minimumSessionDurationChanged();
     }
 }
@@ -308,7 +302,7 @@ void QtFirebaseAnalytics::setMinimumSessionDuration(unsigned int minimumSessionD
 void QtFirebaseAnalytics::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << self << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::init" << "base not ready";
         return;
     }
 
@@ -316,7 +310,7 @@ void QtFirebaseAnalytics::init()
         _initializing = true;
 
         analytics::Initialize(*qFirebase->firebaseApp());
-        qDebug() << self << "::init" << "native initialized";
+        qtfbDebug(lcQtFirebaseAnalytics) << self << "::init" << "native initialized";
         _initializing = false;
         setReady(true);
     }
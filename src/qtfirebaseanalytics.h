@@ -40,7 +40,7 @@ public:
     static QtFirebaseAnalytics *instance() {
         if(!self) {
             self = new QtFirebaseAnalytics();
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseAnalytics) << self << "::instance" << "singleton";
         }
         return self;
     }
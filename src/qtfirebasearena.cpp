@@ -0,0 +1,130 @@
+#include "qtfirebasearena.h"
+
+#include <QtGlobal>
+
+#include <cstdint>
+
+QtFirebaseArena::QtFirebaseArena(size_t blockSize) :
+    m_pos(m_inline),
+    m_end(m_inline + InlineSize),
+    m_blocks(nullptr),
+    m_cleanups(nullptr),
+    m_blockSize(blockSize),
+    m_nextBlockSize(blockSize),
+    m_retired(0)
+{
+}
+
+QtFirebaseArena::~QtFirebaseArena()
+{
+    release();
+}
+
+void *QtFirebaseArena::allocate(size_t size, size_t alignment)
+{
+    Q_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    uintptr_t address = (reinterpret_cast<uintptr_t>(m_pos) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if(address + size > reinterpret_cast<uintptr_t>(m_end)) {
+        grow(size + alignment);
+        address = (reinterpret_cast<uintptr_t>(m_pos) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+
+    m_pos = reinterpret_cast<char *>(address + size);
+    return reinterpret_cast<void *>(address);
+}
+
+const char *QtFirebaseArena::utf8(const QString &string, int *size)
+{
+    // Worst case is three bytes per UTF-16 unit, the unused tail is handed back right away
+    char *start = static_cast<char *>(allocate(static_cast<size_t>(string.size()) * 3 + 1, 1));
+    const int written = encodeUtf8(string, start);
+    start[written] = '\0';
+
+    m_pos = start + written + 1;
+    if(size)
+        *size = written;
+    return start;
+}
+
+int QtFirebaseArena::encodeUtf8(const QString &string, char *start)
+{
+    unsigned char *out = reinterpret_cast<unsigned char *>(start);
+
+    const ushort *in = reinterpret_cast<const ushort *>(string.constData());
+    const ushort *end = in + string.size();
+    while(in < end) {
+        uint c = *in++;
+        if(c < 0x80) {
+            *out++ = static_cast<unsigned char>(c);
+            continue;
+        }
+        if(c < 0x800) {
+            *out++ = static_cast<unsigned char>(0xc0 | (c >> 6));
+            *out++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+            continue;
+        }
+        if(QChar::isHighSurrogate(c) && in < end && QChar::isLowSurrogate(*in)) {
+            c = QChar::surrogateToUcs4(static_cast<ushort>(c), *in++);
+            *out++ = static_cast<unsigned char>(0xf0 | (c >> 18));
+            *out++ = static_cast<unsigned char>(0x80 | ((c >> 12) & 0x3f));
+            *out++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3f));
+            *out++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+            continue;
+        }
+        if(QChar::isSurrogate(c))
+            c = QChar::ReplacementCharacter; // unpaired, same as QString::toUtf8()
+        *out++ = static_cast<unsigned char>(0xe0 | (c >> 12));
+        *out++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3f));
+        *out++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+    }
+
+    return static_cast<int>(reinterpret_cast<char *>(out) - start);
+}
+
+void QtFirebaseArena::release()
+{
+    for(Cleanup *cleanup = m_cleanups; cleanup; cleanup = cleanup->next)
+        cleanup->destroy(cleanup->objects, cleanup->count);
+    m_cleanups = nullptr;
+
+    while(m_blocks) {
+        Block *next = m_blocks->next;
+        ::operator delete(m_blocks);
+        m_blocks = next;
+    }
+
+    m_pos = m_inline;
+    m_end = m_inline + InlineSize;
+    m_nextBlockSize = m_blockSize;
+    m_retired = 0;
+}
+
+size_t QtFirebaseArena::bytesUsed() const
+{
+    const char *begin = m_blocks ? reinterpret_cast<const char *>(m_blocks + 1) : m_inline;
+    return m_retired + static_cast<size_t>(m_pos - begin);
+}
+
+int QtFirebaseArena::heapBlocks() const
+{
+    int count = 0;
+    for(const Block *block = m_blocks; block; block = block->next)
+        ++count;
+    return count;
+}
+
+void QtFirebaseArena::grow(size_t minimum)
+{
+    const char *begin = m_blocks ? reinterpret_cast<const char *>(m_blocks + 1) : m_inline;
+    m_retired += static_cast<size_t>(m_pos - begin);
+
+    const size_t size = qMax(m_nextBlockSize, minimum);
+    Block *block = static_cast<Block *>(::operator new(sizeof(Block) + size));
+    block->next = m_blocks;
+    m_blocks = block;
+
+    m_pos = reinterpret_cast<char *>(block + 1);
+    m_end = m_pos + size;
+    m_nextBlockSize = qMin(m_nextBlockSize * 2, static_cast<size_t>(MaxBlockSize));
+}
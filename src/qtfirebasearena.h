@@ -0,0 +1,109 @@
+#ifndef QTFIREBASE_ARENA_H
+#define QTFIREBASE_ARENA_H
+
+#include <QString>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/*
+ * Monotonic scratch memory for a single operation
+ *
+ * Transient data handed to the SDK (UTF-8 keys and strings, parameter arrays) is
+ * bump allocated and released in one go when the arena goes out of scope.
+ * The first kilobyte lives inside the arena itself, so a typical call on a stack
+ * allocated arena does not touch the heap at all.
+ *
+ * Usage:
+ *   QtFirebaseArena arena;
+ *   analytics::Parameter *parameters = arena.create<analytics::Parameter>(count);
+ *   parameters[0] = analytics::Parameter(arena.utf8(key), arena.utf8(value));
+ *   analytics::LogEvent(arena.utf8(name), parameters, count);
+ *
+ * Pointers into the arena must not be kept by anything that outlives it.
+ */
+class QtFirebaseArena
+{
+public:
+    explicit QtFirebaseArena(size_t blockSize = DefaultBlockSize);
+    ~QtFirebaseArena();
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Value initialized objects, their destructors run when the arena is released
+    template <typename T>
+    T *create(size_t count)
+    {
+        if(count == 0)
+            return nullptr;
+
+        T *objects = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        for(size_t i = 0; i < count; ++i)
+            new (objects + i) T();
+
+        if(!std::is_trivially_destructible<T>::value) {
+            Cleanup *cleanup = static_cast<Cleanup *>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+            cleanup->next = m_cleanups;
+            cleanup->destroy = &destroy<T>;
+            cleanup->objects = objects;
+            cleanup->count = count;
+            m_cleanups = cleanup;
+        }
+        return objects;
+    }
+
+    // NUL terminated UTF-8 copy of string, encoded straight into the arena
+    const char *utf8(const QString &string, int *size = nullptr);
+    // Encodes string into out, which must hold 3 * string.size() bytes. Returns the bytes written, no NUL
+    static int encodeUtf8(const QString &string, char *out);
+
+    // Drops everything, the arena can be used again
+    void release();
+
+    size_t bytesUsed() const;
+    int heapBlocks() const;
+
+    enum {
+        InlineSize = 1024,
+        DefaultBlockSize = 4096,
+        MaxBlockSize = 256 * 1024
+    };
+
+private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    struct Cleanup
+    {
+        Cleanup *next;
+        void (*destroy)(void *objects, size_t count);
+        void *objects;
+        size_t count;
+    };
+
+    template <typename T>
+    static void destroy(void *objects, size_t count)
+    {
+        T *typed = static_cast<T *>(objects);
+        for(size_t i = count; i > 0; --i)
+            typed[i - 1].~T();
+    }
+
+    void grow(size_t minimum);
+
+    alignas(std::max_align_t) char m_inline[InlineSize];
+    char *m_pos;
+    char *m_end;
+    Block *m_blocks;
+    Cleanup *m_cleanups;
+    size_t m_blockSize;
+    size_t m_nextBlockSize;
+    size_t m_retired; // bytes used in blocks that are no longer current
+
+    Q_DISABLE_COPY(QtFirebaseArena)
+};
+
+#endif // QTFIREBASE_ARENA_H
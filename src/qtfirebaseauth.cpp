@@ -8,15 +8,21 @@ QtFirebaseAuth::QtFirebaseAuth(QObject *parent) : QtFirebaseService(parent),
     m_auth(nullptr)
     ,m_complete(false)
     ,m_signedIn(false)
+    ,m_timeout(0)
     ,m_errId(ErrorNone)
     ,m_action(ActionSignIn)
 {
     if(self == 0)
     {
         self = this;
-        qDebug() << self << "::QtFirebaseAuth" << "singleton";
+        qtfbDebug(lcQtFirebaseAuth) << self << "::QtFirebaseAuth" << "singleton";
     }
-    startInit();
+    // GetAuth only takes the SDK's own lock, no need to block the GUI thread with it
+    // NOTE this is only copied into the Task, which runs on the GUI thread while this is alive
+    startInit([this]() -> QtFirebaseInitScheduler::Task {
+        auth::Auth *instance = auth::Auth::GetAuth(qFirebase->firebaseApp());
+        return [this, instance]() { m_auth = instance; };
+    });
 }
 
 QtFirebaseAuth::~QtFirebaseAuth()
@@ -45,7 +51,7 @@ void QtFirebaseAuth::registerUser(const QString &email, const QString &pass)
     m_action = ActionRegister;
     firebase::Future<auth::User*> future =
            m_auth->CreateUserWithEmailAndPassword(email.toUtf8().constData(), pass.toUtf8().constData());
-    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".auth.register"), future);
+    addFuture(QStringLiteral("auth.register"), future, m_timeout, QtFirebaseMetrics::AuthRegister);
 }
 
 void QtFirebaseAuth::deleteUser()
@@ -61,7 +67,7 @@ void QtFirebaseAuth::deleteUser()
     setComplete(false);
 
     firebase::Future<void> future = m_auth->current_user()->Delete();
-    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".auth.deleteUser"), future);
+    addFuture(QStringLiteral("auth.deleteUser"), future, m_timeout, QtFirebaseMetrics::AuthDeleteUser);
 }
 
 void QtFirebaseAuth::sendPasswordResetEmail(const QString &email)
@@ -73,7 +79,7 @@ void QtFirebaseAuth::sendPasswordResetEmail(const QString &email)
     setComplete(false);
     firebase::Future<void> future =
            m_auth->SendPasswordResetEmail(email.toUtf8().constData());
-    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".auth.resetEmail"), future);
+    addFuture(QStringLiteral("auth.resetEmail"), future, m_timeout, QtFirebaseMetrics::AuthPasswordReset);
 }
 
 
@@ -99,7 +105,7 @@ void QtFirebaseAuth::signIn(const QString &email, const QString &pass)
     firebase::Future<auth::User*> future =
                   m_auth->SignInWithEmailAndPassword(email.toUtf8().constData(), pass.toUtf8().constData());
 
-    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".auth.signin"), future);
+    addFuture(QStringLiteral("auth.signin"), future, m_timeout, QtFirebaseMetrics::AuthSignIn);
 }
 
 bool QtFirebaseAuth::running() const
@@ -107,6 +113,20 @@ bool QtFirebaseAuth::running() const
     return !m_complete;
 }
 
+int QtFirebaseAuth::timeout() const
+{
+    return m_timeout;
+}
+
+void QtFirebaseAuth::setTimeout(int timeout)
+{
+    if(m_timeout != timeout)
+    {
+        m_timeout = timeout;
+        emit timeoutChanged();
+    }
+}
+
 void QtFirebaseAuth::signOut()
 {
     m_action = ActionSignOut;
@@ -195,16 +215,17 @@ void QtFirebaseAuth::setSignIn(bool value)
 void QtFirebaseAuth::init()
 {
     if(!qFirebase->ready()) {
-        // NOTE using "self" pointer with qDebug() sometimes lead to crashes during life-cycle:
+        // NOTE using "self" pointer with qtfbDebug(lcQtFirebaseAuth) sometimes lead to crashes during life-cycle:
         // init -> terminate -> init -> crash
-        qDebug() << this << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseAuth) << this << "::init" << "base not ready";
         return;
     }
 
     if(!ready() && !initializing()) {
         setInitializing(true);
-        m_auth = auth::Auth::GetAuth(qFirebase->firebaseApp());
-        qDebug() << this << "::init" << "native initialized";
+        if(!m_auth)
+            m_auth = auth::Auth::GetAuth(qFirebase->firebaseApp());
+        qtfbDebug(lcQtFirebaseAuth) << this << "::init" << "native initialized";
         setInitializing(false);
         setReady(true);
 
@@ -219,25 +240,27 @@ void QtFirebaseAuth::init()
 
 void QtFirebaseAuth::onFutureEvent(QString eventId, firebase::FutureBase future)
 {
-    if(!eventId.startsWith(__QTFIREBASE_ID + QStringLiteral(".auth")))
-        return;
+    qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent" << eventId;
 
-    qDebug() << this << "::onFutureEvent" << eventId;
-
-    if(future.status() != firebase::kFutureStatusComplete)
+    if(future.status() == firebase::kFutureStatusPending)
+    {
+        qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent" << eventId << "timed out after" << m_timeout << "ms";
+        setError(ErrorTimeout, QStringLiteral("Operation timed out"));
+    }
+    else if(future.status() != firebase::kFutureStatusComplete)
     {
-        qDebug() << this << "::onFutureEvent register user failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
+        qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent register user failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
         setError(ErrorFailure, QStringLiteral("Unknown error"));
     }
     else if(future.error()==auth::kAuthErrorNone)
     {
         clearError();
-        if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.register"))
+        if(eventId == QStringLiteral("auth.register"))
         {
             if(future.result_void() == nullptr)
             {
                 setError(ErrorFailure, QStringLiteral("Registered user is null"));
-                qDebug() << "Registered user is null";
+                qtfbDebug(lcQtFirebaseAuth) << "Registered user is null";
             }
             else
             {
@@ -246,66 +269,66 @@ void QtFirebaseAuth::onFutureEvent(QString eventId, firebase::FutureBase future)
                                                  : nullptr;
                 if(user!=nullptr)
                 {
-                    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".auth.sendemailverify"), user->SendEmailVerification());
+                    addFuture(QStringLiteral("auth.sendemailverify"), user->SendEmailVerification(), m_timeout, QtFirebaseMetrics::AuthEmailVerification);
                 }
             }
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.sendemailverify"))
+        else if(eventId == QStringLiteral("auth.sendemailverify"))
         {
-            qDebug() << this << "::onFutureEvent Verification email sent successfully";
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Verification email sent successfully";
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.deleteUser"))
+        else if(eventId == QStringLiteral("auth.deleteUser"))
         {
-            qDebug() << this << "::onFutureEvent Delete user successfully";
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Delete user successfully";
             setSignIn(false);
         }
 
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.resetEmail"))
+        else if(eventId == QStringLiteral("auth.resetEmail"))
         {
             emit passwordResetEmailSent();
-            qDebug() << this << "::onFutureEvent reset email sent successfully";
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent reset email sent successfully";
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.signin"))
+        else if(eventId == QStringLiteral("auth.signin"))
         {
 
-            qDebug() << this << "::onFutureEvent Sign in successful";
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Sign in successful";
             auth::User* user = result<auth::User*>(future.result_void())
                                              ? *(result<auth::User*>(future.result_void()))
                                              : nullptr;
             if(user!=nullptr)
             {
                 setSignIn(true);
-                /*qDebug() << "Email:" << user->email().c_str();
-                qDebug() << "Display name:" << user->display_name().c_str();
-                qDebug() << "Photo url:" << user->photo_url().c_str();
-                qDebug() << "provider_id:" << user->provider_id().c_str();
-                qDebug() << "is_anonymous:" << user->is_anonymous();
-                qDebug() << "is_email_verified:" << user->is_email_verified();*/
+                /*qtfbDebug(lcQtFirebaseAuth) << "Email:" << user->email().c_str();
+                qtfbDebug(lcQtFirebaseAuth) << "Display name:" << user->display_name().c_str();
+                qtfbDebug(lcQtFirebaseAuth) << "Photo url:" << user->photo_url().c_str();
+                qtfbDebug(lcQtFirebaseAuth) << "provider_id:" << user->provider_id().c_str();
+                qtfbDebug(lcQtFirebaseAuth) << "is_anonymous:" << user->is_anonymous();
+                qtfbDebug(lcQtFirebaseAuth) << "is_email_verified:" << user->is_email_verified();*/
             }
         }
     }
     else
     {
-        if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.register"))
+        if(eventId == QStringLiteral("auth.register"))
         {
-            qDebug() << this << "::onFutureEvent Registering user completed with error:" << future.error() << future.error_message();
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Registering user completed with error:" << future.error() << future.error_message();
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.sendemailverify"))
+        else if(eventId == QStringLiteral("auth.sendemailverify"))
         {
-            qDebug() << this << "::onFutureEvent Verification email send error:" << future.error() << future.error_message();
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Verification email send error:" << future.error() << future.error_message();
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.signin"))
+        else if(eventId == QStringLiteral("auth.signin"))
         {
             setSignIn(false);
-            qDebug() << this << "::onFutureEvent Sign in error:" << future.error() << future.error_message();
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Sign in error:" << future.error() << future.error_message();
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.resetEmail"))
+        else if(eventId == QStringLiteral("auth.resetEmail"))
         {
-            qDebug() << this << "::onFutureEvent reset email error" << future.error() << future.error_message();
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent reset email error" << future.error() << future.error_message();
         }
-        else if(eventId == __QTFIREBASE_ID + QStringLiteral(".auth.deleteUser"))
+        else if(eventId == QStringLiteral("auth.deleteUser"))
         {
-            qDebug() << this << "::onFutureEvent Delete user error" << future.error() << future.error_message();
+            qtfbDebug(lcQtFirebaseAuth) << this << "::onFutureEvent Delete user error" << future.error() << future.error_message();
         }
         setError(future.error(), QString::fromUtf8(future.error_message()));
     }
@@ -16,13 +16,15 @@ class QtFirebaseAuth : public QtFirebaseService
     Q_OBJECT
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
     Q_PROPERTY(bool signedIn READ signedIn NOTIFY signedInChanged)
+    // Milliseconds before a running action fails with ErrorTimeout, 0 (default) waits forever
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
 public:
     static QtFirebaseAuth *instance()
     {
         if(self == nullptr)
         {
             self = new QtFirebaseAuth(0);
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseAuth) << self << "::instance" << "singleton";
         }
         return self;
     }
@@ -31,6 +33,7 @@ public:
 
     enum Error
     {
+        ErrorTimeout = firebase::auth::kAuthErrorNone-1, // QtFirebase: the action timeout passed
         ErrorNone = firebase::auth::kAuthErrorNone,
         ErrorUnimplemented = firebase::auth::kAuthErrorUnimplemented,
         ErrorFailure = firebase::auth::kAuthErrorFailure
@@ -59,6 +62,8 @@ public slots:
     //Status
     bool signedIn() const;
     bool running() const;
+    int timeout() const;
+    void setTimeout(int timeout);
     int errorId() const;
     QString errorMsg() const;
 
@@ -72,6 +77,7 @@ public slots:
 signals:
     void signedInChanged();
     void runningChanged();
+    void timeoutChanged();
     void completed(bool success, int actionId);
     void passwordResetEmailSent();
 
@@ -91,6 +97,7 @@ private:
 
     bool m_complete;
     bool m_signedIn;
+    int m_timeout;
     int m_errId;
     QString m_errMsg;
     int m_action;
@@ -0,0 +1,618 @@
+#ifndef QTFIREBASE_BINDING_H
+#define QTFIREBASE_BINDING_H
+
+#include "qtfirebaseservice.h"
+
+#include "firebase/variant.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMetaProperty>
+#include <QString>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class QtFirebaseSnapshotNode;
+
+/*
+ * Typed decoding and encoding between firebase::Variant trees and C++ types
+ *
+ * Records are read straight into user structs, without QVariantMap trees.
+ * Structs describe their fields with a function found through ADL. The same function
+ * is used in both directions, field names must be string literals:
+ *
+ *   struct Player
+ *   {
+ *       QString name;
+ *       qint64 score = 0;
+ *       QVector<QString> tags;
+ *   };
+ *
+ *   template <typename Visitor>
+ *   void qtFirebaseFields(Visitor &visit, Player &player)
+ *   {
+ *       visit("name", player.name);
+ *       visit("score", player.score);
+ *       visit("tags", player.tags);
+ *   }
+ *
+ *   Player player;
+ *   if(QtFirebaseBinding::decode(variant, player))   // or snapshot->read(player), or a snapshot node
+ *       ...
+ *   request->setVariant(QtFirebaseBinding::encode(player));
+ *
+ * Q_GADGET types without such a function are mapped through their writable properties.
+ * That path converts each field through QVariant (nested gadgets are not supported there),
+ * the field function path boxes nothing.
+ *
+ * Supported field types: bool, integers, floating point numbers, QString, std::string,
+ * QByteArray (as string, blobs are accepted when decoding), QVariant, described structs and
+ * gadgets, and QVector, QList, std::vector, QMap, QHash and std::map (string keys) of those.
+ * Missing and null values leave the field untouched, decode() returns false when a value
+ * has a type, or for integers a range, that does not fit its field (the other fields are
+ * still decoded).
+ */
+class QtFirebaseBinding
+{
+public:
+    template <typename T>
+    static bool decode(const firebase::Variant &variant, T &value)
+    {
+        return variant.is_null() || decodeValue(variant, value);
+    }
+
+    // Straight from a snapshot tree (e.g. a subtree of QtFirebaseDataSnapshot::data()), nothing is copied
+    // but the values of QVariant fields and gadget properties
+    template <typename T>
+    static bool decode(const QtFirebaseSnapshotNode &node, T &value)
+    {
+        return decodeTree(node, value);
+    }
+
+    template <typename T>
+    static firebase::Variant encode(const T &value)
+    {
+        return encodeValue(value);
+    }
+
+private:
+    // Field function detection, the visitor type does not matter for the check
+    struct FieldProbe
+    {
+        template <typename F> void operator()(const char *, F &) {}
+    };
+
+    template <typename T>
+    struct HasFields
+    {
+        template <typename U>
+        static auto check(int) -> decltype(qtFirebaseFields(std::declval<FieldProbe &>(), std::declval<U &>()), std::true_type());
+        template <typename U>
+        static std::false_type check(...);
+        static const bool value = decltype(check<T>(0))::value;
+    };
+
+    template <typename T>
+    struct IsGadget
+    {
+        template <typename U>
+        static std::true_type check(typename U::QtGadgetHelper *);
+        template <typename U>
+        static std::false_type check(...);
+        static const bool value = decltype(check<T>(nullptr))::value && !HasFields<T>::value;
+    };
+
+    template <typename T>
+    struct IsInteger
+    {
+        static const bool value = std::is_integral<T>::value && !std::is_same<T, bool>::value;
+    };
+
+    class Decoder
+    {
+    public:
+        explicit Decoder(const std::map<firebase::Variant, firebase::Variant> &map) : m_map(map), m_ok(true) {}
+
+        template <typename F>
+        void operator()(const char *name, F &field)
+        {
+            // Static string keys compare like any other string key, the lookup allocates nothing
+            std::map<firebase::Variant, firebase::Variant>::const_iterator it = m_map.find(firebase::Variant::FromStaticString(name));
+            if(it != m_map.end() && !it->second.is_null() && !decodeValue(it->second, field))
+                m_ok = false;
+        }
+
+        bool ok() const { return m_ok; }
+
+    private:
+        const std::map<firebase::Variant, firebase::Variant> &m_map;
+        bool m_ok;
+    };
+
+    class Encoder
+    {
+    public:
+        explicit Encoder(std::map<firebase::Variant, firebase::Variant> &map) : m_map(map) {}
+
+        template <typename F>
+        void operator()(const char *name, F &field)
+        {
+            m_map[firebase::Variant::FromStaticString(name)] = encodeValue(field);
+        }
+
+    private:
+        std::map<firebase::Variant, firebase::Variant> &m_map;
+    };
+
+    static bool isString(const firebase::Variant &v)
+    {
+        return v.type() == firebase::Variant::kTypeStaticString || v.type() == firebase::Variant::kTypeMutableString;
+    }
+
+    static void stringData(const firebase::Variant &v, const char *&data, int &size)
+    {
+        if(v.type() == firebase::Variant::kTypeMutableString) {
+            const std::string &str = v.mutable_string();
+            data = str.data();
+            size = static_cast<int>(str.size());
+        } else {
+            data = v.string_value();
+            size = static_cast<int>(qstrlen(data));
+        }
+    }
+
+    // Decoding of scalars
+
+    static bool decodeValue(const firebase::Variant &v, bool &value)
+    {
+        if(!v.is_bool())
+            return false;
+        value = v.bool_value();
+        return true;
+    }
+
+    template <typename T>
+    static typename std::enable_if<IsInteger<T>::value, bool>::type decodeValue(const firebase::Variant &v, T &value)
+    {
+        if(v.is_int64()) {
+            if(!fits<T>(v.int64_value()))
+                return false;
+            value = static_cast<T>(v.int64_value());
+            return true;
+        }
+        // The database hands out whole numbers written from JavaScript as doubles.
+        // NOTE range checked before the cast, NaN and anything outside of int64 are undefined there
+        if(v.is_double()) {
+            const double d = v.double_value();
+            if(!std::isfinite(d) || d < -9223372036854775808.0 || d >= 9223372036854775808.0)
+                return false;
+            const int64_t whole = static_cast<int64_t>(d);
+            if(static_cast<double>(whole) != d || !fits<T>(whole))
+                return false;
+            value = static_cast<T>(whole);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    static bool fits(int64_t x)
+    {
+        if(std::is_signed<T>::value)
+            return x >= static_cast<int64_t>(std::numeric_limits<T>::min()) && x <= static_cast<int64_t>(std::numeric_limits<T>::max());
+        return x >= 0 && static_cast<uint64_t>(x) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, bool>::type decodeValue(const firebase::Variant &v, T &value)
+    {
+        if(!v.is_numeric())
+            return false;
+        value = static_cast<T>(v.is_int64() ? static_cast<double>(v.int64_value()) : v.double_value());
+        return true;
+    }
+
+    static bool decodeValue(const firebase::Variant &v, QString &value)
+    {
+        if(!isString(v))
+            return false;
+        const char *data;
+        int size;
+        stringData(v, data, size);
+        value = QString::fromUtf8(data, size);
+        return true;
+    }
+
+    static bool decodeValue(const firebase::Variant &v, QByteArray &value)
+    {
+        if(v.is_blob()) {
+            value = QByteArray(reinterpret_cast<const char *>(v.blob_data()), static_cast<int>(v.blob_size()));
+            return true;
+        }
+        if(!isString(v))
+            return false;
+        const char *data;
+        int size;
+        stringData(v, data, size);
+        value = QByteArray(data, size);
+        return true;
+    }
+
+    static bool decodeValue(const firebase::Variant &v, std::string &value)
+    {
+        if(!isString(v))
+            return false;
+        const char *data;
+        int size;
+        stringData(v, data, size);
+        value.assign(data, static_cast<size_t>(size));
+        return true;
+    }
+
+    static bool decodeValue(const firebase::Variant &v, QVariant &value)
+    {
+        value = QtFirebaseService::fromFirebaseVariant(v);
+        return true;
+    }
+
+    // Decoding of containers, sparse arrays come back from the database as maps and are read in key order
+
+    template <typename Container>
+    static bool decodeSequence(const firebase::Variant &v, Container &value)
+    {
+        Container result;
+        bool ok = true;
+        if(v.is_vector()) {
+            const std::vector<firebase::Variant> &vector = v.vector();
+            result.reserve(static_cast<int>(vector.size()));
+            for(const firebase::Variant &item : vector) {
+                result.push_back(typename Container::value_type());
+                if(!item.is_null() && !decodeValue(item, result.back()))
+                    ok = false;
+            }
+        } else if(v.is_map()) {
+            for(const auto &entry : v.map()) {
+                result.push_back(typename Container::value_type());
+                if(!entry.second.is_null() && !decodeValue(entry.second, result.back()))
+                    ok = false;
+            }
+        } else {
+            return false;
+        }
+        value = std::move(result);
+        return ok;
+    }
+
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, QVector<T> &value) { return decodeSequence(v, value); }
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, QList<T> &value) { return decodeSequence(v, value); }
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, std::vector<T> &value) { return decodeSequence(v, value); }
+
+    template <typename Container, typename Key>
+    static bool decodeAssociative(const firebase::Variant &v, Container &value)
+    {
+        if(!v.is_map())
+            return false;
+
+        Container result;
+        bool ok = true;
+        for(const auto &entry : v.map()) {
+            Key key;
+            if(!decodeValue(entry.first, key)) {
+                ok = false;
+                continue;
+            }
+            typename Container::mapped_type item;
+            if(!entry.second.is_null() && !decodeValue(entry.second, item))
+                ok = false;
+            insert(result, std::move(key), std::move(item));
+        }
+        value = std::move(result);
+        return ok;
+    }
+
+    template <typename T>
+    static void insert(QMap<QString, T> &map, QString &&key, T &&item) { map.insert(map.cend(), key, item); }
+    template <typename T>
+    static void insert(QHash<QString, T> &hash, QString &&key, T &&item) { hash.insert(key, item); }
+    template <typename T>
+    static void insert(std::map<std::string, T> &map, std::string &&key, T &&item) { map.emplace_hint(map.end(), std::move(key), std::move(item)); }
+
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, QMap<QString, T> &value) { return decodeAssociative<QMap<QString, T>, QString>(v, value); }
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, QHash<QString, T> &value) { return decodeAssociative<QHash<QString, T>, QString>(v, value); }
+    template <typename T>
+    static bool decodeValue(const firebase::Variant &v, std::map<std::string, T> &value) { return decodeAssociative<std::map<std::string, T>, std::string>(v, value); }
+
+    // Decoding of records
+
+    template <typename T>
+    static typename std::enable_if<HasFields<T>::value, bool>::type decodeValue(const firebase::Variant &v, T &value)
+    {
+        if(!v.is_map())
+            return false;
+        Decoder decoder(v.map());
+        qtFirebaseFields(decoder, value);
+        return decoder.ok();
+    }
+
+    template <typename T>
+    static typename std::enable_if<IsGadget<T>::value, bool>::type decodeValue(const firebase::Variant &v, T &value)
+    {
+        if(!v.is_map())
+            return false;
+
+        const std::map<firebase::Variant, firebase::Variant> &map = v.map();
+        const QMetaObject &metaObject = T::staticMetaObject;
+        bool ok = true;
+        for(int i = metaObject.propertyOffset(); i < metaObject.propertyCount(); ++i) {
+            const QMetaProperty property = metaObject.property(i);
+            if(!property.isWritable())
+                continue;
+            // Property names live in the static moc data
+            std::map<firebase::Variant, firebase::Variant>::const_iterator it = map.find(firebase::Variant::FromStaticString(property.name()));
+            if(it == map.end() || it->second.is_null())
+                continue;
+            if(!property.writeOnGadget(&value, QtFirebaseService::fromFirebaseVariant(it->second)))
+                ok = false;
+        }
+        return ok;
+    }
+
+    // Decoding of snapshot trees (QtFirebaseSnapshotNode, a template parameter here as its
+    // header includes this one). Leaves go through the variant decoders above
+
+    template <typename Node>
+    static bool isNull(const Node &node)
+    {
+        return !node.isMap() && !node.isVector() && node.leaf().is_null();
+    }
+
+    template <typename Node, typename T>
+    static bool decodeTree(const Node &node, T &value)
+    {
+        return isNull(node) || decodeNode(node, value);
+    }
+
+    template <typename Node, typename T>
+    static typename std::enable_if<!HasFields<T>::value && !IsGadget<T>::value, bool>::type decodeNode(const Node &node, T &value)
+    {
+        // Only QVariant fields take containers among these, they get a copy of the subtree
+        if(node.isMap() || node.isVector())
+            return decodeValue(node.toVariant(), value);
+        return decodeValue(node.leaf(), value);
+    }
+
+    template <typename Node, typename Container>
+    static bool decodeNodeSequence(const Node &node, Container &value)
+    {
+        if(!node.isMap() && !node.isVector())
+            return false;
+
+        Container result;
+        bool ok = true;
+        result.reserve(static_cast<int>(node.children().size()));
+        for(const auto &child : node.children()) {
+            result.push_back(typename Container::value_type());
+            if(!isNull(*child.second) && !decodeNode(*child.second, result.back()))
+                ok = false;
+        }
+        value = std::move(result);
+        return ok;
+    }
+
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, QVector<T> &value) { return decodeNodeSequence(node, value); }
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, QList<T> &value) { return decodeNodeSequence(node, value); }
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, std::vector<T> &value) { return decodeNodeSequence(node, value); }
+
+    static void decodeKey(const std::string &key, QString &value) { value = QString::fromStdString(key); }
+    static void decodeKey(const std::string &key, std::string &value) { value = key; }
+
+    template <typename Container, typename Key, typename Node>
+    static bool decodeNodeAssociative(const Node &node, Container &value)
+    {
+        if(!node.isMap())
+            return false;
+
+        Container result;
+        bool ok = true;
+        for(const auto &child : node.children()) {
+            Key key;
+            decodeKey(child.first, key);
+            typename Container::mapped_type item;
+            if(!isNull(*child.second) && !decodeNode(*child.second, item))
+                ok = false;
+            insert(result, std::move(key), std::move(item));
+        }
+        value = std::move(result);
+        return ok;
+    }
+
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, QMap<QString, T> &value) { return decodeNodeAssociative<QMap<QString, T>, QString>(node, value); }
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, QHash<QString, T> &value) { return decodeNodeAssociative<QHash<QString, T>, QString>(node, value); }
+    template <typename Node, typename T>
+    static bool decodeNode(const Node &node, std::map<std::string, T> &value) { return decodeNodeAssociative<std::map<std::string, T>, std::string>(node, value); }
+
+    // Map children are sorted by key, fields are found by binary search without building a key
+    template <typename Node>
+    static const Node *findChild(const Node &node, const char *name)
+    {
+        const auto &children = node.children();
+        const auto it = std::lower_bound(children.begin(), children.end(), name,
+                                         [](const typename Node::Child &child, const char *name) { return child.first.compare(name) < 0; });
+        return it != children.end() && it->first.compare(name) == 0 ? it->second.data() : nullptr;
+    }
+
+    template <typename Node>
+    class NodeDecoder
+    {
+    public:
+        explicit NodeDecoder(const Node &node) : m_node(node), m_ok(true) {}
+
+        template <typename F>
+        void operator()(const char *name, F &field)
+        {
+            const Node *child = findChild(m_node, name);
+            if(child && !isNull(*child) && !decodeNode(*child, field))
+                m_ok = false;
+        }
+
+        bool ok() const { return m_ok; }
+
+    private:
+        const Node &m_node;
+        bool m_ok;
+    };
+
+    template <typename Node, typename T>
+    static typename std::enable_if<HasFields<T>::value, bool>::type decodeNode(const Node &node, T &value)
+    {
+        if(!node.isMap())
+            return false;
+        NodeDecoder<Node> decoder(node);
+        qtFirebaseFields(decoder, value);
+        return decoder.ok();
+    }
+
+    template <typename Node, typename T>
+    static typename std::enable_if<IsGadget<T>::value, bool>::type decodeNode(const Node &node, T &value)
+    {
+        if(!node.isMap())
+            return false;
+
+        const QMetaObject &metaObject = T::staticMetaObject;
+        bool ok = true;
+        for(int i = metaObject.propertyOffset(); i < metaObject.propertyCount(); ++i) {
+            const QMetaProperty property = metaObject.property(i);
+            if(!property.isWritable())
+                continue;
+            const Node *child = findChild(node, property.name());
+            if(!child || isNull(*child))
+                continue;
+            const QVariant field = child->isMap() || child->isVector() ? QtFirebaseService::fromFirebaseVariant(child->toVariant())
+                                                                       : QtFirebaseService::fromFirebaseVariant(child->leaf());
+            if(!property.writeOnGadget(&value, field))
+                ok = false;
+        }
+        return ok;
+    }
+
+    // Encoding
+
+    static firebase::Variant encodeValue(bool value) { return firebase::Variant(value); }
+
+    template <typename T>
+    static typename std::enable_if<IsInteger<T>::value, firebase::Variant>::type encodeValue(T value)
+    {
+        return firebase::Variant(static_cast<int64_t>(value));
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, firebase::Variant>::type encodeValue(T value)
+    {
+        return firebase::Variant(static_cast<double>(value));
+    }
+
+    static firebase::Variant encodeValue(const QString &value) { return firebase::Variant(value.toStdString()); }
+    // As a string, the database rejects blobs
+    static firebase::Variant encodeValue(const QByteArray &value)
+    {
+        firebase::Variant result{std::string()};
+        result.mutable_string().assign(value.constData(), static_cast<size_t>(value.size()));
+        return result;
+    }
+    static firebase::Variant encodeValue(const std::string &value) { return firebase::Variant(value); }
+    static firebase::Variant encodeValue(const QVariant &value) { return QtFirebaseService::fromQtVariant(value); }
+
+    template <typename Container>
+    static firebase::Variant encodeSequence(const Container &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyVector();
+        std::vector<firebase::Variant> &vector = result.vector();
+        vector.reserve(static_cast<size_t>(value.size()));
+        for(const auto &item : value)
+            vector.push_back(encodeValue(item));
+        return result;
+    }
+
+    template <typename T>
+    static firebase::Variant encodeValue(const QVector<T> &value) { return encodeSequence(value); }
+    template <typename T>
+    static firebase::Variant encodeValue(const QList<T> &value) { return encodeSequence(value); }
+    template <typename T>
+    static firebase::Variant encodeValue(const std::vector<T> &value) { return encodeSequence(value); }
+
+    template <typename T>
+    static firebase::Variant encodeValue(const QMap<QString, T> &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyMap();
+        std::map<firebase::Variant, firebase::Variant> &map = result.map();
+        for(auto it = value.cbegin(); it != value.cend(); ++it)
+            map[firebase::Variant(it.key().toStdString())] = encodeValue(it.value());
+        return result;
+    }
+
+    template <typename T>
+    static firebase::Variant encodeValue(const QHash<QString, T> &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyMap();
+        std::map<firebase::Variant, firebase::Variant> &map = result.map();
+        for(auto it = value.cbegin(); it != value.cend(); ++it)
+            map[firebase::Variant(it.key().toStdString())] = encodeValue(it.value());
+        return result;
+    }
+
+    template <typename T>
+    static firebase::Variant encodeValue(const std::map<std::string, T> &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyMap();
+        std::map<firebase::Variant, firebase::Variant> &map = result.map();
+        for(const auto &entry : value)
+            map[firebase::Variant(entry.first)] = encodeValue(entry.second);
+        return result;
+    }
+
+    template <typename T>
+    static typename std::enable_if<HasFields<T>::value, firebase::Variant>::type encodeValue(const T &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyMap();
+        Encoder encoder(result.map());
+        // The field function takes a non const record for decoding, the encoder only reads from it
+        qtFirebaseFields(encoder, const_cast<T &>(value));
+        return result;
+    }
+
+    template <typename T>
+    static typename std::enable_if<IsGadget<T>::value, firebase::Variant>::type encodeValue(const T &value)
+    {
+        firebase::Variant result = firebase::Variant::EmptyMap();
+        std::map<firebase::Variant, firebase::Variant> &map = result.map();
+        const QMetaObject &metaObject = T::staticMetaObject;
+        for(int i = metaObject.propertyOffset(); i < metaObject.propertyCount(); ++i) {
+            const QMetaProperty property = metaObject.property(i);
+            if(property.isReadable() && property.isStored())
+                map[firebase::Variant::FromStaticString(property.name())] = QtFirebaseService::fromQtVariant(property.readOnGadget(&value));
+        }
+        return result;
+    }
+};
+
+#endif // QTFIREBASE_BINDING_H
@@ -1,83 +1,448 @@
 #include "qtfirebasedatabase.h"
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJSEngine>
+#include <QPointer>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
 namespace db = ::firebase::database;
 
 QtFirebaseDatabase* QtFirebaseDatabase::self = 0;
 
+namespace DatabaseActions {
+    const QString Set = QStringLiteral("set");
+    const QString Get = QStringLiteral("get");
+    const QString Update = QStringLiteral("update");
+    const QString Remove = QStringLiteral("remove");
+}
+
+static QtFirebaseMetrics::Operation metricsOperation(const QString &action)
+{
+    if(action == DatabaseActions::Get)
+        return QtFirebaseMetrics::DatabaseGet;
+    if(action == DatabaseActions::Set)
+        return QtFirebaseMetrics::DatabaseSet;
+    if(action == DatabaseActions::Update)
+        return QtFirebaseMetrics::DatabaseUpdate;
+    if(action == DatabaseActions::Remove)
+        return QtFirebaseMetrics::DatabaseRemove;
+    return QtFirebaseMetrics::None;
+}
+
+static int futureError(const firebase::FutureBase &future, QString *msg)
+{
+    if(future.status() == firebase::kFutureStatusPending)
+    {
+        *msg = QStringLiteral("Operation timed out");
+        return QtFirebaseDatabase::ErrorTimeout;
+    }
+    if(future.status() != firebase::kFutureStatusComplete)
+    {
+        *msg = QString();
+        return QtFirebaseDatabase::ErrorUnknownError;
+    }
+    *msg = future.error() != firebase::database::kErrorNone ? QString::fromUtf8(future.error_message()) : QString();
+    return future.error();
+}
+
+static QString normalizedPath(const QString &path)
+{
+    return path.split(QLatin1Char('/'), QString::SkipEmptyParts).join(QLatin1Char('/'));
+}
+
+// One of the locations contains the other (the root contains everything)
+static bool overlaps(const QString &a, const QString &b)
+{
+    if(a.isEmpty() || b.isEmpty() || a == b)
+        return true;
+    const QString &shorter = a.size() < b.size() ? a : b;
+    const QString &longer = a.size() < b.size() ? b : a;
+    return longer.startsWith(shorter) && longer.at(shorter.size()) == QLatin1Char('/');
+}
+
+// Rough heap size of a tree, shared subtrees are counted for every tree they are in
+static size_t nodeBytes(const QtFirebaseSnapshotNode::Pointer &node)
+{
+    if(!node)
+        return 0;
+    size_t bytes = sizeof(QtFirebaseSnapshotNode) + 2 * sizeof(void*) + node->children().capacity() * sizeof(QtFirebaseSnapshotNode::Child);
+    const firebase::Variant &leaf = node->leaf();
+    if(leaf.is_string())
+        bytes += std::strlen(leaf.string_value()) + 1;
+    else if(leaf.is_blob())
+        bytes += leaf.blob_size();
+    for(const QtFirebaseSnapshotNode::Child &child : node->children())
+        bytes += child.first.capacity() + nodeBytes(child.second);
+    return bytes;
+}
+
+/*
+ * Recent read results and the reads in flight, keyed by location and filters
+ *
+ * Entries expire after the TTL and are dropped least recently used first beyond the budget.
+ * NOTE a handful of entries is the expected size, eviction simply scans for the oldest one
+ */
+class QtFirebaseDatabaseCache
+{
+public:
+    struct Flight
+    {
+        Flight(): stale(false) {}
+
+        QString path;
+        QVector<QPointer<QtFirebaseDatabaseRequest>> readers;
+        // A write to the location was issued while reading, the result is not cached
+        bool stale;
+    };
+
+    QtFirebaseDatabaseCache():
+        m_ttl(0)
+        ,m_budget(4 * 1024 * 1024)
+        ,m_bytes(0)
+    {
+        m_clock.start();
+    }
+
+    // Fresh entry for key, an invalid one on a miss
+    QtFirebaseSnapshotData find(const QString &key)
+    {
+        QHash<QString, Entry>::iterator entry = m_entries.find(key);
+        if(entry == m_entries.end())
+            return QtFirebaseSnapshotData();
+        const qint64 now = m_clock.elapsed();
+        if(now - entry->stored > m_ttl)
+        {
+            m_bytes -= entry->bytes;
+            m_entries.erase(entry);
+            return QtFirebaseSnapshotData();
+        }
+        entry->used = now;
+        return entry->data;
+    }
+
+    void insert(const QString &key, const QString &path, const QtFirebaseSnapshotData &data)
+    {
+        if(m_ttl <= 0)
+            return;
+        remove(key);
+        Entry entry;
+        entry.path = path;
+        entry.data = data;
+        entry.stored = entry.used = m_clock.elapsed();
+        entry.bytes = nodeBytes(data.root()) + static_cast<size_t>(key.size() + path.size()) * sizeof(QChar);
+        if(entry.bytes > m_budget)
+            return;
+        m_bytes += entry.bytes;
+        m_entries.insert(key, entry);
+        trim();
+    }
+
+    void remove(const QString &key)
+    {
+        QHash<QString, Entry>::iterator entry = m_entries.find(key);
+        if(entry != m_entries.end())
+        {
+            m_bytes -= entry->bytes;
+            m_entries.erase(entry);
+        }
+    }
+
+    void invalidate(const QString &path)
+    {
+        for(QHash<QString, Entry>::iterator entry = m_entries.begin(); entry != m_entries.end();)
+        {
+            if(overlaps(entry->path, path))
+            {
+                m_bytes -= entry->bytes;
+                entry = m_entries.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+        for(Flight &flight : m_flights)
+        {
+            if(overlaps(flight.path, path))
+                flight.stale = true;
+        }
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_bytes = 0;
+        for(Flight &flight : m_flights)
+            flight.stale = true;
+    }
+
+    int ttl() const { return m_ttl; }
+    void setTtl(int ttl)
+    {
+        m_ttl = ttl;
+        if(m_ttl <= 0)
+        {
+            m_entries.clear();
+            m_bytes = 0;
+        }
+    }
+    size_t budget() const { return m_budget; }
+    void setBudget(size_t bytes) { m_budget = bytes; trim(); }
+    size_t bytes() const { return m_bytes; }
+
+    QHash<QString, Flight> &flights() { return m_flights; }
+
+private:
+    struct Entry
+    {
+        QString path;
+        QtFirebaseSnapshotData data;
+        qint64 stored;
+        qint64 used;
+        size_t bytes;
+    };
+
+    void trim()
+    {
+        while(m_bytes > m_budget && !m_entries.isEmpty())
+        {
+            QHash<QString, Entry>::iterator oldest = m_entries.begin();
+            for(QHash<QString, Entry>::iterator entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+            {
+                if(entry->used < oldest->used)
+                    oldest = entry;
+            }
+            m_bytes -= oldest->bytes;
+            m_entries.erase(oldest);
+        }
+    }
+
+    QElapsedTimer m_clock;
+    int m_ttl;
+    size_t m_budget;
+    size_t m_bytes;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, Flight> m_flights;
+};
+
 QtFirebaseDatabase::QtFirebaseDatabase(QObject *parent) : QtFirebaseService(parent),
     m_db(nullptr)
+    ,m_cache(new QtFirebaseDatabaseCache)
+    ,m_cacheHits(0)
+    ,m_cacheMisses(0)
+    ,m_cacheCoalesced(0)
+{
+    qRegisterMetaType<QtFirebaseSnapshotData>();
+    // GetInstance only takes the SDK's own lock, no need to block the GUI thread with it
+    // NOTE this is only copied into the Task, which runs on the GUI thread while this is alive
+    startInit([this]() -> QtFirebaseInitScheduler::Task {
+        db::Database *database = db::Database::GetInstance(qFirebase->firebaseApp());
+        return [this, database]() { m_db = database; };
+    });
+}
+
+QtFirebaseDatabase::~QtFirebaseDatabase()
 {
-    startInit();
 }
 
 void QtFirebaseDatabase::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << self << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::init" << "base not ready";
         return;
     }
 
     if(!ready() && !initializing()) {
         setInitializing(true);
-        m_db = db::Database::GetInstance(qFirebase->firebaseApp());
-        qDebug() << self << "::init" << "native initialized";
+        if(!m_db)
+            m_db = db::Database::GetInstance(qFirebase->firebaseApp());
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::init" << "native initialized";
         setInitializing(false);
         setReady(true);
     }
 }
 
-void QtFirebaseDatabase::onFutureEvent(QString eventId, firebase::FutureBase future)
+void QtFirebaseDatabase::addFuture(const QString &action, QtFirebaseDatabaseRequest *request, const firebase::FutureBase &future)
 {
-    if(!eventId.startsWith(__QTFIREBASE_ID))
-        return;
+    // Operations are keyed by their future handle, so any number of requests
+    // (each running any action) can be in flight at the same time
+    QPointer<QtFirebaseDatabaseRequest> target(request);
+    const QtFirebaseFutureHandle handle = qFirebase->addFuture(future, this, [this, action, target](QtFirebaseFutureHandle futureHandle, const firebase::FutureBase &completed) {
+        {
+            QMutexLocker locker(&m_futureMutex);
+            m_requests.remove(futureHandle);
+        }
+
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::onFutureEvent" << action << futureHandle;
+
+        // Called without holding the mutex, the request may start a new operation right away
+        if(target)
+            target->onFutureEvent(action, completed);
+        else
+            qtfbDebug(lcQtFirebaseDatabase) << this << "::onFutureEvent request object is gone, dropping" << action;
+    }, request->timeout(), metricsOperation(action));
 
-    qDebug() << self << "::onFutureEvent" << eventId;
+    QMutexLocker locker(&m_futureMutex);
+    m_requests.insert(handle, request);
+}
 
+void QtFirebaseDatabase::unregisterRequest(QtFirebaseDatabaseRequest *request)
+{
     QMutexLocker locker(&m_futureMutex);
-    QMap<QString, QtFirebaseDatabaseRequest*>::iterator it = m_requests.find(eventId);
-    if(it!=m_requests.end() && it.value()!=nullptr)
+    for(auto it = m_requests.begin(); it != m_requests.end();)
+    {
+        if(it.value() == request)
+        {
+            qFirebase->removeFuture(it.key());
+            it = m_requests.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void QtFirebaseDatabase::read(QtFirebaseDatabaseRequest *request, const QString &key, const QString &path,
+                              firebase::database::Query query, bool ordered)
+{
+    const QtFirebaseSnapshotData cached = m_cache->find(key);
+    if(cached.isValid())
     {
-        QtFirebaseDatabaseRequest* request = it.value();
-        m_requests.erase(it);
-        QString id = eventId.right(eventId.size()-prefix().size());
-        request->onFutureEvent(id, future);
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::read" << "cache hit" << key;
+        ++m_cacheHits;
+        emit cacheStatsChanged();
+        // Completes after exec() returned, like a download would
+        QPointer<QtFirebaseDatabaseRequest> target(request);
+        QMetaObject::invokeMethod(this, [target, cached]() {
+            if(target)
+                target->onReadResult(cached, ErrorNone, QString());
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    QHash<QString, QtFirebaseDatabaseCache::Flight> &flights = m_cache->flights();
+    QHash<QString, QtFirebaseDatabaseCache::Flight>::iterator flight = flights.find(key);
+    if(flight != flights.end())
+    {
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::read" << "joining the read in flight" << key;
+        flight->readers.append(request);
+        ++m_cacheCoalesced;
+        emit cacheStatsChanged();
+        return;
     }
+
+    QtFirebaseDatabaseCache::Flight started;
+    started.path = path;
+    started.readers.append(request);
+    flights.insert(key, started);
+    ++m_cacheMisses;
+
+    // Shares whatever did not change since the reader's last result
+    const QtFirebaseSnapshotData previous = request->m_snapshot ? request->m_snapshot->data() : QtFirebaseSnapshotData();
+    firebase::Future<db::DataSnapshot> future = query.GetValue();
+    qFirebase->addFuture(future, this, [this, key, ordered, previous](QtFirebaseFutureHandle, const firebase::FutureBase &completed) {
+        finishRead(key, ordered, previous, completed);
+    }, request->timeout(), QtFirebaseMetrics::DatabaseGet);
+    emit cacheStatsChanged();
+}
+
+void QtFirebaseDatabase::finishRead(const QString &key, bool ordered, const QtFirebaseSnapshotData &previous, const firebase::FutureBase &future)
+{
+    QString msg;
+    const int errId = futureError(future, &msg);
+    QtFirebaseSnapshotData data;
+    if(errId == ErrorNone)
+        data = QtFirebaseSnapshotData(*::result<db::DataSnapshot>(future.result_void()), previous, ordered);
     else
+        qtfbDebug(lcQtFirebaseDatabase) << self << "::finishRead" << key << "failed:" << errId << msg;
+
+    // Taken out first, readers may start the same read again from their handlers
+    const QtFirebaseDatabaseCache::Flight flight = m_cache->flights().take(key);
+    if(errId == ErrorNone && !flight.stale)
+    {
+        m_cache->insert(key, flight.path, data);
+        emit cacheStatsChanged();
+    }
+    for(const QPointer<QtFirebaseDatabaseRequest> &reader : flight.readers)
     {
-        qDebug() << this << "::onFutureEvent internal error, no request object found";
+        if(reader)
+            reader->onReadResult(data, errId, msg);
     }
 }
 
-QtFirebaseDatabaseRequest *QtFirebaseDatabase::request(const QString &futureKey) const
+int QtFirebaseDatabase::cacheTtl() const
 {
-    auto it = m_requests.find(futureKey);
-    return it!=m_requests.end() ? *it : nullptr;
+    return m_cache->ttl();
 }
 
-void QtFirebaseDatabase::addFuture(QString requestId, QtFirebaseDatabaseRequest *request, firebase::FutureBase future)
+void QtFirebaseDatabase::setCacheTtl(int ttl)
 {
-    QString futureKey = prefix() + requestId;
-    qFirebase->addFuture(futureKey, future);
-    m_requests[futureKey] = request;
+    if(m_cache->ttl() != ttl)
+    {
+        m_cache->setTtl(ttl);
+        emit cacheTtlChanged();
+        emit cacheStatsChanged();
+    }
 }
 
-void QtFirebaseDatabase::unregisterRequest(QtFirebaseDatabaseRequest *request)
+int QtFirebaseDatabase::cacheBudget() const
 {
-    QMutexLocker locker(&m_futureMutex);
-    for(QMap<QString, QtFirebaseDatabaseRequest*>::iterator it = m_requests.begin();it!=m_requests.end();++it)
+    return static_cast<int>(m_cache->budget());
+}
+
+void QtFirebaseDatabase::setCacheBudget(int bytes)
+{
+    bytes = qMax(0, bytes);
+    if(cacheBudget() != bytes)
     {
-        if(it.value() == request)
-        {
-            m_requests.erase(it);
-            break;
-        }
+        m_cache->setBudget(static_cast<size_t>(bytes));
+        emit cacheBudgetChanged();
+        emit cacheStatsChanged();
     }
 }
 
-QString QtFirebaseDatabase::prefix() const
+int QtFirebaseDatabase::cacheBytes() const
+{
+    return static_cast<int>(m_cache->bytes());
+}
+
+int QtFirebaseDatabase::cacheHits() const
+{
+    return m_cacheHits;
+}
+
+int QtFirebaseDatabase::cacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+int QtFirebaseDatabase::cacheCoalesced() const
+{
+    return m_cacheCoalesced;
+}
+
+void QtFirebaseDatabase::clearCache()
+{
+    m_cache->clear();
+    emit cacheStatsChanged();
+}
+
+void QtFirebaseDatabase::invalidateCache(const QString &path)
+{
+    m_cache->invalidate(normalizedPath(path));
+    emit cacheStatsChanged();
+}
+
+void QtFirebaseDatabase::resetCacheStats()
 {
-    return __QTFIREBASE_ID + QStringLiteral(".db.");
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_cacheCoalesced = 0;
+    emit cacheStatsChanged();
 }
 
 //====================QtFirebaseDatabaseQuery=====================/
@@ -90,73 +455,79 @@ QtFirebaseDatabaseQuery::QtFirebaseDatabaseQuery():
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::orderByKey()
 {
-    m_query = m_query.OrderByKey();
+    add(Filter{Filter::OrderByKey, firebase::Variant(), std::string(), false, 0}, QStringLiteral("orderByKey"));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::orderByValue()
 {
-    m_query = m_query.OrderByValue();
+    add(Filter{Filter::OrderByValue, firebase::Variant(), std::string(), false, 0}, QStringLiteral("orderByValue"));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::orderByChild(const QString &path)
 {
-    m_query = m_query.OrderByChild(path.toUtf8().constData());
+    add(Filter{Filter::OrderByChild, firebase::Variant(), path.toStdString(), true, 0}, QStringLiteral("orderByChild=") + path);
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::orderByPriority()
 {
-    m_query = m_query.OrderByPriority();
+    add(Filter{Filter::OrderByPriority, firebase::Variant(), std::string(), false, 0}, QStringLiteral("orderByPriority"));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::startAt(QVariant order_value)
 {
-    m_query = m_query.StartAt(QtFirebaseService::fromQtVariant(order_value));
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::StartAt, value, std::string(), false, 0}, QStringLiteral("startAt=") + valueKey(value));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::startAt(QVariant order_value, const QString &child_key)
 {
-    m_query = m_query.StartAt(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData());
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::StartAt, value, child_key.toStdString(), true, 0}, QStringLiteral("startAt=") + valueKey(value) + QLatin1Char(',') + child_key);
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::endAt(QVariant order_value)
 {
-    m_query = m_query.EndAt(QtFirebaseService::fromQtVariant(order_value));
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::EndAt, value, std::string(), false, 0}, QStringLiteral("endAt=") + valueKey(value));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::endAt(QVariant order_value, const QString &child_key)
 {
-    m_query = m_query.EndAt(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData());
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::EndAt, value, child_key.toStdString(), true, 0}, QStringLiteral("endAt=") + valueKey(value) + QLatin1Char(',') + child_key);
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::equalTo(QVariant order_value)
 {
-    m_query = m_query.EqualTo(QtFirebaseService::fromQtVariant(order_value));
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::EqualTo, value, std::string(), false, 0}, QStringLiteral("equalTo=") + valueKey(value));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::equalTo(QVariant order_value, const QString &child_key)
 {
-    m_query = m_query.EqualTo(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData());
+    const firebase::Variant value = QtFirebaseService::fromQtVariant(order_value);
+    add(Filter{Filter::EqualTo, value, child_key.toStdString(), true, 0}, QStringLiteral("equalTo=") + valueKey(value) + QLatin1Char(',') + child_key);
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::limitToFirst(size_t limit)
 {
-    m_query = m_query.LimitToFirst(limit);
+    add(Filter{Filter::LimitToFirst, firebase::Variant(), std::string(), false, limit}, QStringLiteral("limitToFirst=") + QString::number(limit));
     return this;
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseQuery::limitToLast(size_t limit)
 {
-    m_query = m_query.LimitToLast(limit);
+    add(Filter{Filter::LimitToLast, firebase::Variant(), std::string(), false, limit}, QStringLiteral("limitToLast=") + QString::number(limit));
     return this;
 }
 
@@ -168,6 +539,8 @@ void QtFirebaseDatabaseQuery::exec()
 void QtFirebaseDatabaseQuery::clear()
 {
     m_valid = false;
+    m_filters.clear();
+    m_key.clear();
 }
 
 bool QtFirebaseDatabaseQuery::valid() const
@@ -175,31 +548,88 @@ bool QtFirebaseDatabaseQuery::valid() const
     return m_valid;
 }
 
-QtFirebaseDatabaseQuery* QtFirebaseDatabaseQuery::setQuery(const firebase::database::Query &query)
+QtFirebaseDatabaseQuery* QtFirebaseDatabaseQuery::begin()
 {
-    m_valid = true;
-    m_query = query;
+    if(!m_valid)
+    {
+        m_valid = true;
+        m_filters.clear();
+        m_key.clear();
+    }
     return this;
 }
 
-firebase::database::Query &QtFirebaseDatabaseQuery::query()
+const QtFirebaseDatabaseQuery::Filters &QtFirebaseDatabaseQuery::filters() const
 {
-    return m_query;
+    return m_filters;
 }
 
-//================QtFirebaseDatabaseRequest===================
+firebase::database::Query QtFirebaseDatabaseQuery::build(const firebase::database::Query &base, const Filters &filters)
+{
+    firebase::database::Query query = base;
+    for(const Filter &filter : filters)
+    {
+        switch(filter.kind)
+        {
+            case Filter::OrderByKey:
+                query = query.OrderByKey();
+                break;
+            case Filter::OrderByValue:
+                query = query.OrderByValue();
+                break;
+            case Filter::OrderByChild:
+                query = query.OrderByChild(filter.text.c_str());
+                break;
+            case Filter::OrderByPriority:
+                query = query.OrderByPriority();
+                break;
+            case Filter::StartAt:
+                query = filter.hasText ? query.StartAt(filter.value, filter.text.c_str()) : query.StartAt(filter.value);
+                break;
+            case Filter::EndAt:
+                query = filter.hasText ? query.EndAt(filter.value, filter.text.c_str()) : query.EndAt(filter.value);
+                break;
+            case Filter::EqualTo:
+                query = filter.hasText ? query.EqualTo(filter.value, filter.text.c_str()) : query.EqualTo(filter.value);
+                break;
+            case Filter::LimitToFirst:
+                query = query.LimitToFirst(filter.limit);
+                break;
+            case Filter::LimitToLast:
+                query = query.LimitToLast(filter.limit);
+                break;
+        }
+    }
+    return query;
+}
 
-namespace DatabaseActions {
-    const QString Set = QStringLiteral("set");
-    const QString Get = QStringLiteral("get");
-    const QString Update = QStringLiteral("update");
-    const QString Remove = QStringLiteral("remove");
+QString QtFirebaseDatabaseQuery::key() const
+{
+    return m_key;
+}
+
+void QtFirebaseDatabaseQuery::add(const Filter &filter, const QString &key)
+{
+    m_filters.push_back(filter);
+    if(!m_key.isEmpty())
+        m_key += QLatin1Char('&');
+    m_key += key;
 }
 
+QString QtFirebaseDatabaseQuery::valueKey(const firebase::Variant &value)
+{
+    // Typed, so 1 and "1" stay different filters
+    return QString::fromUtf8(QtFirebaseJson::toJson(value, QtFirebaseJson::Compact));
+}
+
+//================QtFirebaseDatabaseRequest===================
+
 QtFirebaseDatabaseRequest::QtFirebaseDatabaseRequest():
     m_inComplexRequest(false)
     ,m_snapshot(nullptr)
+    ,m_ordered(false)
     ,m_complete(true)
+    ,m_timeout(0)
 {
     clearError();
     connect(&m_query, SIGNAL(run()),this,SLOT(onRun()));
@@ -222,6 +652,7 @@ QtFirebaseDatabaseRequest* QtFirebaseDatabaseRequest::child(const QString &path)
             m_inComplexRequest = true;
         }
         m_pushChildKey.clear();
+        m_path = normalizedPath(path);
         if(path.isEmpty())
         {
             m_dbRef = qFirebaseDatabase->m_db->GetReference().GetRoot();
@@ -249,12 +680,18 @@ void QtFirebaseDatabaseRequest::remove()
     {
         m_inComplexRequest = false;
         setComplete(false);
+        qFirebaseDatabase->invalidateCache(m_path);
         firebase::Future<void> future = m_dbRef.RemoveValue();
         qFirebaseDatabase->addFuture(DatabaseActions::Remove, this, future);
     }
 }
 
 void QtFirebaseDatabaseRequest::setValue(const QVariant &value)
+{
+    setVariant(QtFirebaseService::fromQtVariant(value));
+}
+
+void QtFirebaseDatabaseRequest::setVariant(const firebase::Variant &value)
 {
     if(m_inComplexRequest && !running())
     {
@@ -263,8 +700,10 @@ void QtFirebaseDatabaseRequest::setValue(const QVariant &value)
         if(!m_pushChildKey.isEmpty())
         {
             m_dbRef = m_dbRef.Child(m_pushChildKey.toUtf8().constData());
+            m_path = normalizedPath(m_path + QLatin1Char('/') + m_pushChildKey);
         }
-        firebase::Future<void> future = m_dbRef.SetValue(QtFirebaseService::fromQtVariant(value));
+        qFirebaseDatabase->invalidateCache(m_path);
+        firebase::Future<void> future = m_dbRef.SetValue(value);
         qFirebaseDatabase->addFuture(DatabaseActions::Set, this, future);
     }
 }
@@ -275,31 +714,74 @@ void QtFirebaseDatabaseRequest::exec()
     {
         m_inComplexRequest = false;
         setComplete(false);
-        if(m_query.valid())
-        {
-            firebase::Future<firebase::database::DataSnapshot> future = m_query.query().GetValue();
-            qFirebaseDatabase->addFuture(DatabaseActions::Get, this, future);
-            m_query.clear();
-        }
-        else
-        {
-            firebase::Future<firebase::database::DataSnapshot> future = m_dbRef.GetValue();
-            qFirebaseDatabase->addFuture(DatabaseActions::Get, this, future);
-        }
+        m_ordered = m_query.valid();
+        // Reads of the same location with the same filters share results and downloads
+        const QString key = m_query.valid() ? m_path + QLatin1Char('?') + m_query.key() : m_path;
+        const firebase::database::Query query = m_query.valid() ? QtFirebaseDatabaseQuery::build(m_dbRef, m_query.filters()) : firebase::database::Query(m_dbRef);
+        m_query.clear();
+        qFirebaseDatabase->read(this, key, m_path, query, m_ordered);
     }
 }
 
 void QtFirebaseDatabaseRequest::updateTree(const QVariant &tree)
 {
+    // Objects from QML arrive as maps, everything else is taken as JSON text
+    if(tree.type() == QVariant::Map)
+        updateChildren(QtFirebaseService::fromQtVariant(tree));
+    else if(tree.type() == QVariant::ByteArray)
+        updateTreeJson(tree.toByteArray());
+    else
+        updateTreeJson(tree.toString().toUtf8());
+}
+
+void QtFirebaseDatabaseRequest::updateTreeJson(const QByteArray &json)
+{
+    firebase::Variant tree;
+    QString error;
+    if(QtFirebaseJson::fromJson(json, tree, &error))
+        updateChildren(tree);
+    else
+        failUpdate(error);
+}
+
+void QtFirebaseDatabaseRequest::updateTreeJson(QIODevice *device)
+{
+    firebase::Variant tree;
+    QString error;
+    if(QtFirebaseJson::read(device, tree, &error))
+        updateChildren(tree);
+    else
+        failUpdate(error);
+}
+
+void QtFirebaseDatabaseRequest::updateChildren(const firebase::Variant &tree)
+{
+    if(!tree.is_map())
+    {
+        failUpdate(QStringLiteral("Tree must be an object"));
+        return;
+    }
     clearError();
     setComplete(false);
-    QJsonDocument doc = QJsonDocument::fromJson(tree.toString().toUtf8());
-    QVariant v(doc.object().toVariantMap());
-    firebase::Variant vfb = QtFirebaseService::fromQtVariant(v);
-    firebase::Future<void> future = qFirebaseDatabase->m_db->GetReference().UpdateChildren(vfb);
+    for(const auto &child : tree.map())
+    {
+        if(child.first.is_string())
+            qFirebaseDatabase->invalidateCache(QString::fromUtf8(child.first.string_value()));
+        else
+            qFirebaseDatabase->clearCache();
+    }
+    firebase::Future<void> future = qFirebaseDatabase->m_db->GetReference().UpdateChildren(tree);
     qFirebaseDatabase->addFuture(DatabaseActions::Update, this, future);
 }
 
+void QtFirebaseDatabaseRequest::failUpdate(const QString &msg)
+{
+    qCWarning(lcQtFirebaseDatabase) << this << "::updateTree" << msg;
+    setComplete(false);
+    setError(QtFirebaseDatabase::ErrorInvalidVariantType, msg);
+    setComplete(true);
+}
+
 int QtFirebaseDatabaseRequest::errorId() const
 {
     return m_errId;
@@ -327,27 +809,33 @@ QtFirebaseDataSnapshot *QtFirebaseDatabaseRequest::snapshot()
 
 void QtFirebaseDatabaseRequest::onFutureEvent(QString eventId, firebase::FutureBase future)
 {
-    if(future.status() != firebase::kFutureStatusComplete)
+    QString msg;
+    const int errId = futureError(future, &msg);
+    if(errId != QtFirebaseDatabase::ErrorNone)
     {
-        qDebug() << this << "::onFutureEvent " << "ERROR: Action failed with status: " << future.status();
-        setError(QtFirebaseDatabase::ErrorUnknownError);
+        qtfbDebug(lcQtFirebaseDatabase) << this << "::onFutureEvent" << eventId << "ERROR:" << errId << msg;
+        setError(errId, msg);
     }
-    else if (future.error() != firebase::database::kErrorNone)
+    m_query.clear();
+    setComplete(true);
+}
+
+void QtFirebaseDatabaseRequest::onReadResult(const QtFirebaseSnapshotData &data, int errId, const QString &msg)
+{
+    if(errId != QtFirebaseDatabase::ErrorNone)
     {
-        qDebug() << this << "::onFutureEvent Error occured in result:" << future.error() << future.error_message();
-        setError(future.error(), future.error_message());
+        qtfbDebug(lcQtFirebaseDatabase) << this << "::onReadResult" << "ERROR:" << errId << msg;
+        setError(errId, msg);
     }
-    else if(eventId == DatabaseActions::Get)
+    else
     {
-        const firebase::database::DataSnapshot* snapshot = ::result<firebase::database::DataSnapshot>(future.result_void());
         if(m_snapshot)
         {
             delete m_snapshot;
         }
-        m_snapshot = new QtFirebaseDataSnapshot(*snapshot);
+        m_snapshot = new QtFirebaseDataSnapshot(data);
         clearError();
     }
-    m_query.clear();
     setComplete(true);
 }
 
@@ -377,87 +865,63 @@ void QtFirebaseDatabaseRequest::clearError()
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::orderByKey()
 {
-    return m_query.valid() ?
-        m_query.orderByKey() :
-        m_query.setQuery(m_dbRef.OrderByKey());
+    return m_query.begin()->orderByKey();
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::orderByValue()
 {
-    return m_query.valid() ?
-        m_query.orderByValue() :
-        m_query.setQuery(m_dbRef.OrderByValue());
+    return m_query.begin()->orderByValue();
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::orderByChild(const QString &path)
 {
-    return m_query.valid() ?
-        m_query.orderByChild(path):
-        m_query.setQuery(m_dbRef.OrderByChild(path.toUtf8().constData()));
+    return m_query.begin()->orderByChild(path);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::orderByPriority()
 {
-    return m_query.valid() ?
-        m_query.orderByPriority() :
-        m_query.setQuery(m_dbRef.OrderByPriority());
+    return m_query.begin()->orderByPriority();
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::startAt(QVariant order_value)
 {
-    return m_query.valid() ?
-        m_query.startAt(order_value) :
-        m_query.setQuery(m_dbRef.StartAt(QtFirebaseService::fromQtVariant(order_value)));
+    return m_query.begin()->startAt(order_value);
 
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::startAt(QVariant order_value, const QString &child_key)
 {
-    return m_query.valid() ?
-        m_query.startAt(order_value, child_key) :
-        m_query.setQuery(m_dbRef.StartAt(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData()));
+    return m_query.begin()->startAt(order_value, child_key);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::endAt(QVariant order_value)
 {
-    return m_query.valid() ?
-        m_query.endAt(order_value) :
-        m_query.setQuery(m_dbRef.EndAt(QtFirebaseService::fromQtVariant(order_value)));
+    return m_query.begin()->endAt(order_value);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::endAt(QVariant order_value, const QString &child_key)
 {
-    return m_query.valid() ?
-        m_query.endAt(order_value, child_key) :
-        m_query.setQuery(m_dbRef.EndAt(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData()));
+    return m_query.begin()->endAt(order_value, child_key);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::equalTo(QVariant order_value)
 {
-    return m_query.valid() ?
-        m_query.equalTo(order_value) :
-        m_query.setQuery(m_dbRef.EqualTo(QtFirebaseService::fromQtVariant(order_value)));
+    return m_query.begin()->equalTo(order_value);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::equalTo(QVariant order_value, const QString &child_key)
 {
-    return m_query.valid() ?
-        m_query.equalTo(order_value, child_key) :
-        m_query.setQuery(m_dbRef.EqualTo(QtFirebaseService::fromQtVariant(order_value), child_key.toUtf8().constData()));
+    return m_query.begin()->equalTo(order_value, child_key);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::limitToFirst(size_t limit)
 {
-    return m_query.valid() ?
-        m_query.limitToFirst(limit) :
-        m_query.setQuery(m_dbRef.LimitToFirst(limit));
+    return m_query.begin()->limitToFirst(limit);
 }
 
 QtFirebaseDatabaseQuery *QtFirebaseDatabaseRequest::limitToLast(size_t limit)
 {
-    return m_query.valid() ?
-        m_query.limitToLast(limit) :
-                m_query.setQuery(m_dbRef.LimitToLast(limit));
+    return m_query.begin()->limitToLast(limit);
 }
 
 bool QtFirebaseDatabaseRequest::running() const
@@ -465,50 +929,1300 @@ bool QtFirebaseDatabaseRequest::running() const
     return !m_complete;
 }
 
+int QtFirebaseDatabaseRequest::timeout() const
+{
+    return m_timeout;
+}
+
+void QtFirebaseDatabaseRequest::setTimeout(int timeout)
+{
+    if(m_timeout != timeout)
+    {
+        m_timeout = timeout;
+        emit timeoutChanged();
+    }
+}
+
 void QtFirebaseDatabaseRequest::onRun()
 {
     exec();
 }
 
-//================QtFirebaseDataSnapshot===================
+//================QtFirebaseSnapshotNode===================
+
+static bool isStringVariant(const firebase::Variant &v)
+{
+    return v.type() == firebase::Variant::kTypeStaticString || v.type() == firebase::Variant::kTypeMutableString;
+}
 
-QtFirebaseDataSnapshot::QtFirebaseDataSnapshot(const firebase::database::DataSnapshot &snapshot):
-    m_snapshot(snapshot)
+QtFirebaseSnapshotNode::QtFirebaseSnapshotNode():
+    m_kind(Leaf)
 {
 
 }
 
-bool QtFirebaseDataSnapshot::exists() const
+QtFirebaseSnapshotNode::Pointer QtFirebaseSnapshotNode::create(firebase::Variant &&value, const Pointer &previous)
 {
-    return m_snapshot.exists();
+    QSharedPointer<QtFirebaseSnapshotNode> node(new QtFirebaseSnapshotNode());
+    if(value.is_map())
+    {
+        std::map<firebase::Variant, firebase::Variant> &map = value.map();
+        const bool comparable = previous && previous->m_kind == Map;
+        bool same = comparable && previous->m_children.size() == map.size();
+
+        node->m_kind = Map;
+        node->m_children.reserve(map.size());
+        for(std::map<firebase::Variant, firebase::Variant>::iterator it = map.begin(); it != map.end(); ++it)
+        {
+            if(!isStringVariant(it->first))
+            {
+                qtfbDebug(lcQtFirebaseDatabase) << "QtFirebaseSnapshotNode::create" << "skipping key of type" << firebase::Variant::TypeName(it->first.type());
+                same = false;
+                continue;
+            }
+            std::string key = it->first.type() == firebase::Variant::kTypeMutableString ? it->first.mutable_string() : std::string(it->first.string_value());
+            const Pointer previousChild = comparable ? previous->child(key) : Pointer();
+            const Pointer child = create(std::move(it->second), previousChild);
+            if(child != previousChild)
+                same = false;
+            node->m_children.emplace_back(std::move(key), child);
+        }
+        if(same)
+            return previous;
+    }
+    else if(value.is_vector())
+    {
+        std::vector<firebase::Variant> &vector = value.vector();
+        const bool comparable = previous && previous->m_kind == Vector;
+        bool same = comparable && previous->m_children.size() == vector.size();
+
+        node->m_kind = Vector;
+        node->m_children.reserve(vector.size());
+        for(size_t i = 0; i < vector.size(); ++i)
+        {
+            const Pointer previousChild = comparable && i < previous->m_children.size() ? previous->m_children[i].second : Pointer();
+            const Pointer child = create(std::move(vector[i]), previousChild);
+            if(child != previousChild)
+                same = false;
+            node->m_children.emplace_back(std::string(), child);
+        }
+        if(same)
+            return previous;
+    }
+    else
+    {
+        if(previous && previous->m_kind == Leaf && previous->m_leaf == value)
+            return previous;
+        node->m_leaf = std::move(value);
+    }
+    return node;
 }
 
-QString QtFirebaseDataSnapshot::key() const
+bool QtFirebaseSnapshotNode::isMap() const
 {
-    return m_snapshot.key();
+    return m_kind == Map;
 }
 
-QVariant QtFirebaseDataSnapshot::value() const
+bool QtFirebaseSnapshotNode::isVector() const
 {
+    return m_kind == Vector;
+}
 
-    return QtFirebaseService::fromFirebaseVariant(m_snapshot.value());
+const firebase::Variant &QtFirebaseSnapshotNode::leaf() const
+{
+    return m_leaf;
 }
 
-QByteArray QtFirebaseDataSnapshot::jsonString() const
+const std::vector<QtFirebaseSnapshotNode::Child> &QtFirebaseSnapshotNode::children() const
 {
-    //Limitation: order queries will not work because of
-    //missing order when getting data through value object and not from snapshot hierarchy
-    //TODO: Improve JSON translation using snapshot hierarchy
-    QJsonDocument doc = QJsonDocument::fromVariant(value());
-    return doc.toJson();
+    return m_children;
 }
 
-bool QtFirebaseDataSnapshot::hasChildren() const
+QtFirebaseSnapshotNode::Pointer QtFirebaseSnapshotNode::child(const std::string &key) const
 {
-    return m_snapshot.has_children();
+    const int index = indexOf(key);
+    return index < 0 ? Pointer() : m_children[static_cast<size_t>(index)].second;
 }
 
-bool QtFirebaseDataSnapshot::valid() const
+int QtFirebaseSnapshotNode::indexOf(const std::string &key) const
+{
+    if(m_kind == Map)
+    {
+        // Same order as the keys of the variant map the children came from
+        std::vector<Child>::const_iterator it = std::lower_bound(m_children.begin(), m_children.end(), key,
+                                                                 [](const Child &child, const std::string &key) { return child.first < key; });
+        return it != m_children.end() && it->first == key ? static_cast<int>(it - m_children.begin()) : -1;
+    }
+    if(m_kind == Vector)
+    {
+        size_t index = 0;
+        for(char c : key)
+        {
+            if(c < '0' || c > '9')
+                return -1;
+            index = index * 10 + static_cast<size_t>(c - '0');
+        }
+        return !key.empty() && index < m_children.size() ? static_cast<int>(index) : -1;
+    }
+    return -1;
+}
+
+firebase::Variant QtFirebaseSnapshotNode::toVariant() const
+{
+    switch(m_kind)
+    {
+        case Map:{
+            firebase::Variant result = firebase::Variant::EmptyMap();
+            std::map<firebase::Variant, firebase::Variant> &map = result.map();
+            for(const Child &child : m_children)
+                map.emplace_hint(map.end(), firebase::Variant(child.first), child.second->toVariant());
+            return result;
+        }
+        case Vector:{
+            firebase::Variant result = firebase::Variant::EmptyVector();
+            std::vector<firebase::Variant> &vector = result.vector();
+            vector.reserve(m_children.size());
+            for(const Child &child : m_children)
+                vector.push_back(child.second->toVariant());
+            return result;
+        }
+        default:
+            return m_leaf;
+    }
+}
+
+bool QtFirebaseSnapshotNode::equals(const Pointer &a, const Pointer &b)
+{
+    // NOTE shared subtrees are equal without looking into them
+    if(a == b)
+        return true;
+    if(!a || !b || a->m_kind != b->m_kind || a->m_children.size() != b->m_children.size())
+        return false;
+    if(a->m_kind == Leaf)
+        return a->m_leaf == b->m_leaf;
+
+    for(size_t i = 0; i < a->m_children.size(); ++i)
+    {
+        if(a->m_children[i].first != b->m_children[i].first || !equals(a->m_children[i].second, b->m_children[i].second))
+            return false;
+    }
+    return true;
+}
+
+//================QtFirebaseSnapshotData===================
+
+QtFirebaseSnapshotData::QtFirebaseSnapshotData():
+    m_valid(false)
+    ,m_exists(false)
 {
-    return m_snapshot.is_valid();
+
+}
+
+QtFirebaseSnapshotData::QtFirebaseSnapshotData(const firebase::database::DataSnapshot &snapshot, const QtFirebaseSnapshotData &previous, bool ordered):
+    m_valid(snapshot.is_valid())
+    ,m_exists(false)
+{
+    if(!m_valid)
+        return;
+
+    m_key = QString::fromStdString(snapshot.key_string());
+    m_exists = snapshot.exists();
+    m_priority = snapshot.priority();
+    // NOTE DataSnapshot::value() builds a new copy of the whole tree (on Android from the
+    // Java objects). It is called exactly once, its leaves are moved into the nodes
+    m_root = QtFirebaseSnapshotNode::create(snapshot.value(), previous.m_root);
+
+    if(ordered && m_root && !m_root->children().empty())
+    {
+        // NOTE only the keys are read from the child snapshots, their values are already in the tree
+        QVector<int> order;
+        order.reserve(static_cast<int>(m_root->children().size()));
+        for(const firebase::database::DataSnapshot &child : snapshot.children())
+        {
+            const int index = m_root->indexOf(child.key_string());
+            if(index >= 0)
+                order.append(index);
+        }
+        if(!std::is_sorted(order.constBegin(), order.constEnd()))
+            m_order = order;
+    }
+}
+
+QtFirebaseSnapshotData::QtFirebaseSnapshotData(const QString &key, const QtFirebaseSnapshotNode::Pointer &root):
+    m_key(key)
+    ,m_valid(true)
+    ,m_exists(root && (root->isMap() || root->isVector() || !root->leaf().is_null()))
+    ,m_root(root)
+{
+
+}
+
+bool QtFirebaseSnapshotData::isValid() const
+{
+    return m_valid;
+}
+
+bool QtFirebaseSnapshotData::exists() const
+{
+    return m_exists;
+}
+
+QString QtFirebaseSnapshotData::key() const
+{
+    return m_key;
+}
+
+QtFirebaseSnapshotNode::Pointer QtFirebaseSnapshotData::root() const
+{
+    return m_root;
+}
+
+firebase::Variant QtFirebaseSnapshotData::priority() const
+{
+    return m_priority;
+}
+
+QtFirebaseSnapshotNode::Pointer QtFirebaseSnapshotData::nodeAt(const QString &path) const
+{
+    // NOTE walks the tree, siblings along the path are never converted
+    const QVector<QStringRef> segments = path.splitRef(QLatin1Char('/'), QString::SkipEmptyParts);
+    QtFirebaseSnapshotNode::Pointer node = m_root;
+    for(const QStringRef &segment : segments)
+    {
+        if(!node)
+            break;
+        node = node->child(segment.toUtf8().toStdString());
+    }
+    return node;
+}
+
+QtFirebaseSnapshotData QtFirebaseSnapshotData::child(const QString &path) const
+{
+    if(!m_valid)
+        return QtFirebaseSnapshotData();
+    const QString key = path.section(QLatin1Char('/'), -1, -1, QString::SectionSkipEmpty);
+    if(key.isEmpty())
+        return *this;
+    return QtFirebaseSnapshotData(key, nodeAt(path));
+}
+
+QtFirebaseSnapshotData QtFirebaseSnapshotData::childAt(int i) const
+{
+    if(i < 0 || i >= childrenCount())
+        return QtFirebaseSnapshotData();
+    const int index = i < m_order.size() ? m_order.at(i) : i;
+    const QtFirebaseSnapshotNode::Child &child = m_root->children()[static_cast<size_t>(index)];
+    // Array elements are keyed by their index
+    const QString key = m_root->isVector() ? QString::number(index) : QString::fromStdString(child.first);
+    return QtFirebaseSnapshotData(key, child.second);
+}
+
+int QtFirebaseSnapshotData::childrenCount() const
+{
+    return m_root ? static_cast<int>(m_root->children().size()) : 0;
+}
+
+bool QtFirebaseSnapshotData::operator==(const QtFirebaseSnapshotData &other) const
+{
+    return m_valid == other.m_valid && m_exists == other.m_exists && m_key == other.m_key
+            && m_priority == other.m_priority && QtFirebaseSnapshotNode::equals(m_root, other.m_root);
+}
+
+bool QtFirebaseSnapshotData::operator!=(const QtFirebaseSnapshotData &other) const
+{
+    return !(*this == other);
+}
+
+//================QtFirebaseDataSnapshot===================
+
+static QVariant nodeValue(const QtFirebaseSnapshotNode::Pointer &node)
+{
+    // NOTE converted straight from the nodes, containers are not copied out of the tree first
+    if(!node)
+        return QVariant();
+    if(node->isMap())
+    {
+        QVariantMap map;
+        for(const QtFirebaseSnapshotNode::Child &child : node->children())
+            map.insert(map.cend(), QString::fromUtf8(child.first.data(), static_cast<int>(child.first.size())), nodeValue(child.second));
+        return map;
+    }
+    if(node->isVector())
+    {
+        QVariantList list;
+        list.reserve(static_cast<int>(node->children().size()));
+        for(const QtFirebaseSnapshotNode::Child &child : node->children())
+            list.append(nodeValue(child.second));
+        return list;
+    }
+    return QtFirebaseService::fromFirebaseVariant(node->leaf());
+}
+
+static QJSValue nodeJSValue(QJSEngine *engine, const QtFirebaseSnapshotNode::Pointer &node)
+{
+    if(!node)
+        return QJSValue(QJSValue::UndefinedValue);
+    if(node->isMap())
+    {
+        QJSValue object = engine->newObject();
+        for(const QtFirebaseSnapshotNode::Child &child : node->children())
+            object.setProperty(QString::fromUtf8(child.first.data(), static_cast<int>(child.first.size())), nodeJSValue(engine, child.second));
+        return object;
+    }
+    if(node->isVector())
+    {
+        const std::vector<QtFirebaseSnapshotNode::Child> &children = node->children();
+        QJSValue array = engine->newArray(static_cast<uint>(children.size()));
+        for(size_t i = 0; i < children.size(); ++i)
+            array.setProperty(static_cast<quint32>(i), nodeJSValue(engine, children[i].second));
+        return array;
+    }
+    return QtFirebaseService::toJSValue(engine, node->leaf());
+}
+
+static void writeNode(QtFirebaseJsonWriter &writer, const QtFirebaseSnapshotNode::Pointer &node)
+{
+    if(!node)
+    {
+        writer.value(firebase::Variant());
+        return;
+    }
+    if(node->isMap())
+    {
+        writer.beginObject();
+        for(const QtFirebaseSnapshotNode::Child &child : node->children())
+        {
+            writer.key(child.first.data(), static_cast<int>(child.first.size()));
+            writeNode(writer, child.second);
+        }
+        writer.endObject();
+        return;
+    }
+    if(node->isVector())
+    {
+        writer.beginArray();
+        for(const QtFirebaseSnapshotNode::Child &child : node->children())
+            writeNode(writer, child.second);
+        writer.endArray();
+        return;
+    }
+    writer.value(node->leaf());
+}
+
+QtFirebaseDataSnapshot::QtFirebaseDataSnapshot(const QtFirebaseSnapshotData &data, QObject *parent):
+    QObject(parent)
+    ,m_data(data)
+{
+
+}
+
+bool QtFirebaseDataSnapshot::exists() const
+{
+    return m_data.exists();
+}
+
+QString QtFirebaseDataSnapshot::key() const
+{
+    return m_data.key();
+}
+
+QVariant QtFirebaseDataSnapshot::value() const
+{
+    return valueAt(QString());
+}
+
+QVariant QtFirebaseDataSnapshot::valueAt(const QString &path) const
+{
+    // NOTE QVariant containers are implicitly shared, handing out the cached value copies nothing
+    QHash<QString, QVariant>::const_iterator cached = m_values.constFind(path);
+    if(cached != m_values.constEnd())
+        return cached.value();
+
+    const QVariant result = nodeValue(m_data.nodeAt(path));
+    m_values.insert(path, result);
+    return result;
+}
+
+QJSValue QtFirebaseDataSnapshot::jsValue() const
+{
+    return jsValueAt(QString());
+}
+
+QJSValue QtFirebaseDataSnapshot::jsValueAt(const QString &path) const
+{
+    QHash<QString, QJSValue>::const_iterator cached = m_jsValues.constFind(path);
+    if(cached != m_jsValues.constEnd())
+        return cached.value();
+
+    // NOTE the engine is known once QML has seen this object, i.e. when called from QML
+    QJSEngine *engine = qjsEngine(this);
+    if(!engine)
+    {
+        qCWarning(lcQtFirebaseDatabase) << this << "::jsValueAt" << "not called from QML, no engine to create the value in";
+        return QJSValue();
+    }
+
+    const QJSValue result = nodeJSValue(engine, m_data.nodeAt(path));
+    m_jsValues.insert(path, result);
+    return result;
+}
+
+QtFirebaseSnapshotData QtFirebaseDataSnapshot::data() const
+{
+    return m_data;
+}
+
+bool QtFirebaseDataSnapshot::equals(QtFirebaseDataSnapshot *other) const
+{
+    return other && m_data == other->m_data;
+}
+
+QtFirebaseDataSnapshot *QtFirebaseDataSnapshot::child(const QString &path)
+{
+    QtFirebaseDataSnapshot *cached = m_children.value(path);
+    return cached ? cached : childSnapshot(path, m_data.child(path));
+}
+
+int QtFirebaseDataSnapshot::childrenCount() const
+{
+    return m_data.childrenCount();
+}
+
+QtFirebaseDataSnapshot *QtFirebaseDataSnapshot::getChild(int i)
+{
+    const QtFirebaseSnapshotData data = m_data.childAt(i);
+    if(!data.isValid())
+        return nullptr;
+    QtFirebaseDataSnapshot *cached = m_children.value(data.key());
+    return cached ? cached : childSnapshot(data.key(), data);
+}
+
+QVariant QtFirebaseDataSnapshot::priority() const
+{
+    return QtFirebaseService::fromFirebaseVariant(m_data.priority());
+}
+
+bool QtFirebaseDataSnapshot::hasChild(const QString &path) const
+{
+    return m_data.child(path).exists();
+}
+
+QtFirebaseDataSnapshot *QtFirebaseDataSnapshot::childSnapshot(const QString &path, const QtFirebaseSnapshotData &data)
+{
+    // NOTE parented, so QML never collects it, it goes away with this snapshot
+    QtFirebaseDataSnapshot *snapshot = new QtFirebaseDataSnapshot(data, this);
+    m_children.insert(path, snapshot);
+    return snapshot;
+}
+
+QByteArray QtFirebaseDataSnapshot::jsonString() const
+{
+    // NOTE maps are sorted by key, orderedJsonString() keeps the order of queries
+    QByteArray json;
+    QtFirebaseJsonWriter writer(&json);
+    writeNode(writer, m_data.root());
+    writer.finish();
+    return json;
+}
+
+QByteArray QtFirebaseDataSnapshot::compactJsonString() const
+{
+    QByteArray json;
+    QtFirebaseJsonWriter writer(&json, QtFirebaseJson::Compact);
+    writeNode(writer, m_data.root());
+    writer.finish();
+    return json;
+}
+
+QVariantList QtFirebaseDataSnapshot::orderedEntries() const
+{
+    QVariantList entries;
+    const int count = m_data.childrenCount();
+    entries.reserve(count);
+    for(int i = 0; i < count; ++i)
+    {
+        const QtFirebaseSnapshotData child = m_data.childAt(i);
+        QVariantMap entry;
+        entry.insert(QStringLiteral("key"), child.key());
+        entry.insert(QStringLiteral("value"), nodeValue(child.root()));
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QByteArray QtFirebaseDataSnapshot::orderedJsonString() const
+{
+    QByteArray json;
+    QtFirebaseJsonWriter writer(&json);
+    writeOrdered(writer);
+    writer.finish();
+    return json;
+}
+
+QByteArray QtFirebaseDataSnapshot::compactOrderedJsonString() const
+{
+    QByteArray json;
+    QtFirebaseJsonWriter writer(&json, QtFirebaseJson::Compact);
+    writeOrdered(writer);
+    writer.finish();
+    return json;
+}
+
+void QtFirebaseDataSnapshot::writeOrdered(QtFirebaseJsonWriter &writer) const
+{
+    writer.beginArray();
+    const int count = m_data.childrenCount();
+    for(int i = 0; i < count; ++i)
+    {
+        const QtFirebaseSnapshotData child = m_data.childAt(i);
+        writer.beginObject();
+        writer.key("key", 3);
+        writer.value(firebase::Variant(child.key().toStdString()));
+        writer.key("value", 5);
+        writeNode(writer, child.root());
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+bool QtFirebaseDataSnapshot::writeJson(QIODevice *device, QtFirebaseJson::Format format) const
+{
+    QtFirebaseJsonWriter writer(device, format);
+    writeNode(writer, m_data.root());
+    return writer.finish();
+}
+
+bool QtFirebaseDataSnapshot::hasChildren() const
+{
+    const QtFirebaseSnapshotNode::Pointer root = m_data.root();
+    return root && !root->children().empty();
+}
+
+bool QtFirebaseDataSnapshot::valid() const
+{
+    return m_data.isValid();
+}
+
+//================QtFirebaseDatabaseListener===================
+
+/*
+ * Receives the SDK callbacks (on a SDK thread) and posts them to the listener object
+ * NOTE The owner is only dereferenced under the lock, detach() clears it before the
+ * listener object goes away. Events already posted are dropped by their generation.
+ * A callback may still be running (or waiting for the lock) when the SDK returns from
+ * removing the listener, so the bridge is only freed through release().
+ */
+class QtFirebaseDatabaseListenerBridge: public db::ValueListener, public db::ChildListener
+{
+public:
+    QtFirebaseDatabaseListenerBridge(QtFirebaseDatabaseListener* owner, int generation, bool ordered):
+        m_owner(owner)
+        ,m_generation(generation)
+        ,m_ordered(ordered)
+    {
+
+    }
+
+    // Call once removed from the SDK: the last reference is dropped on the GUI thread after
+    // a queued round-trip with no callback in flight, repeated for as long as there is one
+    static void release(const QSharedPointer<QtFirebaseDatabaseListenerBridge> &bridge)
+    {
+        bridge->clearOwner();
+        QObject *context = QCoreApplication::instance();
+        if(!context)
+            return;
+        QMetaObject::invokeMethod(context, [bridge]() {
+            if(bridge->m_running.loadAcquire() > 0)
+                release(bridge);
+        }, Qt::QueuedConnection);
+    }
+
+    void OnValueChanged(const db::DataSnapshot &snapshot) override
+    {
+        const Running running(m_running);
+        QMutexLocker locker(&m_mutex);
+        // Consecutive values share everything that did not change
+        m_lastValue = QtFirebaseSnapshotData(snapshot, m_lastValue, m_ordered);
+        post(QtFirebaseDatabaseListener::ValueChanged, m_lastValue, QString());
+    }
+
+    void OnChildAdded(const db::DataSnapshot &snapshot, const char *previous_sibling_key) override
+    {
+        const Running running(m_running);
+        postChild(QtFirebaseDatabaseListener::ChildAdded, snapshot, previous_sibling_key);
+    }
+
+    void OnChildChanged(const db::DataSnapshot &snapshot, const char *previous_sibling_key) override
+    {
+        const Running running(m_running);
+        postChild(QtFirebaseDatabaseListener::ChildChanged, snapshot, previous_sibling_key);
+    }
+
+    void OnChildMoved(const db::DataSnapshot &snapshot, const char *previous_sibling_key) override
+    {
+        const Running running(m_running);
+        postChild(QtFirebaseDatabaseListener::ChildMoved, snapshot, previous_sibling_key);
+    }
+
+    void OnChildRemoved(const db::DataSnapshot &snapshot) override
+    {
+        const Running running(m_running);
+        postChild(QtFirebaseDatabaseListener::ChildRemoved, snapshot, nullptr);
+    }
+
+    void OnCancelled(const db::Error &error, const char *error_message) override
+    {
+        const Running running(m_running);
+        QMutexLocker locker(&m_mutex);
+        post(QtFirebaseDatabaseListener::Cancelled, QtFirebaseSnapshotData(), QString::fromUtf8(error_message), error);
+    }
+
+private:
+    // Counts the callbacks in flight
+    class Running
+    {
+    public:
+        explicit Running(QAtomicInt &count): m_count(count) { m_count.ref(); }
+        ~Running() { m_count.deref(); }
+    private:
+        QAtomicInt &m_count;
+    };
+
+    void clearOwner()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_owner = nullptr;
+    }
+
+    void postChild(int event, const db::DataSnapshot &snapshot, const char *previousKey)
+    {
+        // Built here, off the GUI thread
+        const QtFirebaseSnapshotData data(snapshot);
+        QMutexLocker locker(&m_mutex);
+        post(event, data, previousKey ? QString::fromUtf8(previousKey) : QString());
+    }
+
+    // m_mutex must be held
+    void post(int event, const QtFirebaseSnapshotData &data, const QString &key, int errorId = QtFirebaseDatabase::ErrorNone)
+    {
+        if(!m_owner)
+            return;
+        QPointer<QtFirebaseDatabaseListener> owner(m_owner);
+        const int generation = m_generation;
+        QMetaObject::invokeMethod(m_owner, [owner, generation, event, data, key, errorId]() {
+            if(owner)
+                owner->deliver(generation, event, data, key, errorId);
+        }, Qt::QueuedConnection);
+    }
+
+    QMutex m_mutex;
+    QAtomicInt m_running;
+    QtFirebaseDatabaseListener* m_owner;
+    const int m_generation;
+    const bool m_ordered;
+    QtFirebaseSnapshotData m_lastValue;
+};
+
+QtFirebaseDatabaseListener::QtFirebaseDatabaseListener(QObject *parent):
+    QObject(parent)
+    ,m_valueEvents(false)
+    ,m_childEvents(true)
+    ,m_active(false)
+    ,m_wanted(false)
+    ,m_generation(0)
+    ,m_errId(QtFirebaseDatabase::ErrorNone)
+    ,m_ordered(false)
+{
+    connect(&m_query, SIGNAL(run()), this, SLOT(start()));
+    connect(qFirebaseDatabase, SIGNAL(readyChanged()), this, SLOT(onDatabaseReadyChanged()));
+}
+
+QtFirebaseDatabaseListener::~QtFirebaseDatabaseListener()
+{
+    detach();
+}
+
+QString QtFirebaseDatabaseListener::path() const
+{
+    return m_path;
+}
+
+void QtFirebaseDatabaseListener::setPath(const QString &path)
+{
+    if(m_path != path)
+    {
+        m_path = path;
+        // A query built on the old location no longer applies
+        m_query.clear();
+        detach();
+        m_attached = firebase::database::Query();
+        m_filters.clear();
+        m_ordered = false;
+        emit pathChanged();
+        if(m_wanted)
+            attach();
+    }
+}
+
+bool QtFirebaseDatabaseListener::valueEvents() const
+{
+    return m_valueEvents;
+}
+
+void QtFirebaseDatabaseListener::setValueEvents(bool value)
+{
+    if(m_valueEvents != value)
+    {
+        m_valueEvents = value;
+        emit valueEventsChanged();
+        if(m_wanted)
+            attach();
+    }
+}
+
+bool QtFirebaseDatabaseListener::childEvents() const
+{
+    return m_childEvents;
+}
+
+void QtFirebaseDatabaseListener::setChildEvents(bool value)
+{
+    if(m_childEvents != value)
+    {
+        m_childEvents = value;
+        emit childEventsChanged();
+        if(m_wanted)
+            attach();
+    }
+}
+
+bool QtFirebaseDatabaseListener::active() const
+{
+    return m_active;
+}
+
+int QtFirebaseDatabaseListener::errorId() const
+{
+    return m_errId;
+}
+
+QString QtFirebaseDatabaseListener::errorMsg() const
+{
+    return m_errMsg;
+}
+
+void QtFirebaseDatabaseListener::start()
+{
+    m_wanted = true;
+    m_errId = QtFirebaseDatabase::ErrorNone;
+    m_errMsg.clear();
+    attach();
+}
+
+void QtFirebaseDatabaseListener::stop()
+{
+    m_wanted = false;
+    m_query.clear();
+    detach();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::orderByKey()
+{
+    return m_query.begin()->orderByKey();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::orderByValue()
+{
+    return m_query.begin()->orderByValue();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::orderByChild(const QString &path)
+{
+    return m_query.begin()->orderByChild(path);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::orderByPriority()
+{
+    return m_query.begin()->orderByPriority();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::startAt(QVariant order_value)
+{
+    return m_query.begin()->startAt(order_value);
+
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::startAt(QVariant order_value, const QString &child_key)
+{
+    return m_query.begin()->startAt(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::endAt(QVariant order_value)
+{
+    return m_query.begin()->endAt(order_value);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::endAt(QVariant order_value, const QString &child_key)
+{
+    return m_query.begin()->endAt(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::equalTo(QVariant order_value)
+{
+    return m_query.begin()->equalTo(order_value);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::equalTo(QVariant order_value, const QString &child_key)
+{
+    return m_query.begin()->equalTo(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::limitToFirst(size_t limit)
+{
+    return m_query.begin()->limitToFirst(limit);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListener::limitToLast(size_t limit)
+{
+    return m_query.begin()->limitToLast(limit);
+}
+
+void QtFirebaseDatabaseListener::onDatabaseReadyChanged()
+{
+    if(m_wanted && qFirebaseDatabase->ready())
+        attach();
+}
+
+firebase::database::DatabaseReference QtFirebaseDatabaseListener::reference() const
+{
+    if(!qFirebaseDatabase->m_db)
+        return firebase::database::DatabaseReference();
+    if(m_path.isEmpty())
+        return qFirebaseDatabase->m_db->GetReference();
+    return qFirebaseDatabase->m_db->GetReference(m_path.toUtf8().constData());
+}
+
+void QtFirebaseDatabaseListener::attach()
+{
+    detach();
+    if(!qFirebaseDatabase->ready())
+    {
+        qtfbDebug(lcQtFirebaseDatabase) << this << "::attach" << "database not ready, waiting";
+        return;
+    }
+    if(!m_valueEvents && !m_childEvents)
+        return;
+
+    // Filters set up before the database was ready are only applied now
+    if(m_query.valid())
+    {
+        m_filters = m_query.filters();
+        m_ordered = true;
+        m_query.clear();
+    }
+    const firebase::database::DatabaseReference location = reference();
+    if(!location.is_valid())
+    {
+        qCWarning(lcQtFirebaseDatabase) << this << "::attach" << "no valid location for path" << m_path;
+        return;
+    }
+    m_attached = m_ordered ? QtFirebaseDatabaseQuery::build(location, m_filters) : firebase::database::Query(location);
+
+    m_bridge.reset(new QtFirebaseDatabaseListenerBridge(this, ++m_generation, m_ordered));
+    if(m_valueEvents)
+        m_attached.AddValueListener(m_bridge.data());
+    if(m_childEvents)
+        m_attached.AddChildListener(m_bridge.data());
+    qtfbDebug(lcQtFirebaseDatabase) << this << "::attach" << m_path << "value:" << m_valueEvents << "child:" << m_childEvents;
+    setActive(true);
+}
+
+void QtFirebaseDatabaseListener::detach()
+{
+    if(m_bridge)
+    {
+        m_attached.RemoveValueListener(m_bridge.data());
+        m_attached.RemoveChildListener(m_bridge.data());
+        QtFirebaseDatabaseListenerBridge::release(m_bridge);
+        m_bridge.reset();
+        ++m_generation;
+    }
+    setActive(false);
+}
+
+void QtFirebaseDatabaseListener::setActive(bool value)
+{
+    if(m_active != value)
+    {
+        m_active = value;
+        emit activeChanged();
+    }
+}
+
+void QtFirebaseDatabaseListener::deliver(int generation, int event, const QtFirebaseSnapshotData &data, const QString &key, int errorId)
+{
+    if(generation != m_generation)
+        return;
+
+    if(event == Cancelled)
+    {
+        qtfbDebug(lcQtFirebaseDatabase) << this << "::deliver" << "cancelled:" << errorId << key;
+        m_wanted = false;
+        detach();
+        m_attached = firebase::database::Query();
+        m_filters.clear();
+        m_ordered = false;
+        m_errId = errorId;
+        m_errMsg = key;
+        emit cancelled(errorId, key);
+        return;
+    }
+
+    // Only valid while the handlers run, QML and C++ keep the values (or data())
+    QtFirebaseDataSnapshot* snapshot = new QtFirebaseDataSnapshot(data, this);
+    switch(event)
+    {
+    case ValueChanged:
+        emit valueChanged(snapshot);
+        break;
+    case ChildAdded:
+        emit childAdded(snapshot, key);
+        break;
+    case ChildChanged:
+        emit childChanged(snapshot, key);
+        break;
+    case ChildMoved:
+        emit childMoved(snapshot, key);
+        break;
+    case ChildRemoved:
+        emit childRemoved(snapshot);
+        break;
+    }
+    snapshot->deleteLater();
+}
+
+//================QtFirebaseDatabaseListModel===================
+
+QtFirebaseDatabaseListModel::QtFirebaseDatabaseListModel(QObject *parent):
+    QAbstractListModel(parent)
+    ,m_rolesRead(false)
+{
+    connect(&m_listener, SIGNAL(pathChanged()), this, SIGNAL(pathChanged()));
+    connect(&m_listener, SIGNAL(cancelled(int,QString)), this, SIGNAL(cancelled(int,QString)));
+    connect(&m_listener, SIGNAL(activeChanged()), this, SLOT(onActiveChanged()));
+    connect(&m_listener, SIGNAL(childAdded(QtFirebaseDataSnapshot*,QString)), this, SLOT(onChildAdded(QtFirebaseDataSnapshot*,QString)));
+    connect(&m_listener, SIGNAL(childChanged(QtFirebaseDataSnapshot*,QString)), this, SLOT(onChildChanged(QtFirebaseDataSnapshot*,QString)));
+    connect(&m_listener, SIGNAL(childMoved(QtFirebaseDataSnapshot*,QString)), this, SLOT(onChildMoved(QtFirebaseDataSnapshot*,QString)));
+    connect(&m_listener, SIGNAL(childRemoved(QtFirebaseDataSnapshot*)), this, SLOT(onChildRemoved(QtFirebaseDataSnapshot*)));
+}
+
+int QtFirebaseDatabaseListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant QtFirebaseDatabaseListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+
+    const Row &row = m_rows.at(index.row());
+    if(role == KeyRole || role == Qt::DisplayRole)
+        return row.key;
+    if(role == ValueRole)
+        return nodeValue(row.node);
+
+    const int field = role - FirstFieldRole;
+    if(field < 0 || field >= m_fields.size() || !row.node || !row.node->isMap())
+        return QVariant();
+    return nodeValue(row.node->child(m_fields.at(field).toStdString()));
+}
+
+QHash<int, QByteArray> QtFirebaseDatabaseListModel::roleNames() const
+{
+    m_rolesRead = true;
+    QHash<int, QByteArray> roles;
+    roles.insert(KeyRole, QByteArrayLiteral("key"));
+    roles.insert(ValueRole, QByteArrayLiteral("value"));
+    for(int i = 0; i < m_fields.size(); ++i)
+        roles.insert(FirstFieldRole + i, m_fields.at(i));
+    return roles;
+}
+
+QString QtFirebaseDatabaseListModel::path() const
+{
+    return m_listener.path();
+}
+
+void QtFirebaseDatabaseListModel::setPath(const QString &path)
+{
+    m_listener.setPath(path);
+}
+
+bool QtFirebaseDatabaseListModel::active() const
+{
+    return m_listener.active();
+}
+
+int QtFirebaseDatabaseListModel::count() const
+{
+    return m_rows.size();
+}
+
+int QtFirebaseDatabaseListModel::errorId() const
+{
+    return m_listener.errorId();
+}
+
+QString QtFirebaseDatabaseListModel::errorMsg() const
+{
+    return m_listener.errorMsg();
+}
+
+QtFirebaseSnapshotNode::Pointer QtFirebaseDatabaseListModel::node(int row) const
+{
+    if(row < 0 || row >= m_rows.size())
+        return QtFirebaseSnapshotNode::Pointer();
+    return m_rows.at(row).node;
+}
+
+void QtFirebaseDatabaseListModel::start()
+{
+    m_listener.start();
+}
+
+void QtFirebaseDatabaseListModel::stop()
+{
+    m_listener.stop();
+}
+
+int QtFirebaseDatabaseListModel::indexOf(const QString &key) const
+{
+    return m_index.value(key, -1);
+}
+
+QVariant QtFirebaseDatabaseListModel::get(int row) const
+{
+    return nodeValue(node(row));
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::orderByKey()
+{
+    return m_listener.orderByKey();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::orderByValue()
+{
+    return m_listener.orderByValue();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::orderByChild(const QString &path)
+{
+    return m_listener.orderByChild(path);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::orderByPriority()
+{
+    return m_listener.orderByPriority();
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::startAt(QVariant order_value)
+{
+    return m_listener.startAt(order_value);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::startAt(QVariant order_value, const QString &child_key)
+{
+    return m_listener.startAt(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::endAt(QVariant order_value)
+{
+    return m_listener.endAt(order_value);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::endAt(QVariant order_value, const QString &child_key)
+{
+    return m_listener.endAt(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::equalTo(QVariant order_value)
+{
+    return m_listener.equalTo(order_value);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::equalTo(QVariant order_value, const QString &child_key)
+{
+    return m_listener.equalTo(order_value, child_key);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::limitToFirst(size_t limit)
+{
+    return m_listener.limitToFirst(limit);
+}
+
+QtFirebaseDatabaseQuery *QtFirebaseDatabaseListModel::limitToLast(size_t limit)
+{
+    return m_listener.limitToLast(limit);
+}
+
+void QtFirebaseDatabaseListModel::onActiveChanged()
+{
+    // NOTE every (re)attach replays all current children as childAdded, start over
+    if(m_listener.active() && !m_rows.isEmpty())
+    {
+        beginResetModel();
+        m_rows.clear();
+        m_index.clear();
+        endResetModel();
+        emit countChanged();
+    }
+    emit activeChanged();
+}
+
+void QtFirebaseDatabaseListModel::onChildAdded(QtFirebaseDataSnapshot *snapshot, const QString &previousChildKey)
+{
+    const QtFirebaseSnapshotData data = snapshot->data();
+    if(m_index.contains(data.key()))
+    {
+        onChildChanged(snapshot, previousChildKey);
+        return;
+    }
+
+    const int row = rowAfter(previousChildKey);
+    const bool reset = addRoles(data.root());
+    if(reset)
+        beginResetModel();
+    else
+        beginInsertRows(QModelIndex(), row, row);
+
+    m_rows.insert(row, Row{data.key(), data.root()});
+    reindex(row);
+
+    if(reset)
+        endResetModel();
+    else
+        endInsertRows();
+    emit countChanged();
+}
+
+void QtFirebaseDatabaseListModel::onChildChanged(QtFirebaseDataSnapshot *snapshot, const QString &previousChildKey)
+{
+    const QtFirebaseSnapshotData data = snapshot->data();
+    const int row = indexOf(data.key());
+    if(row < 0)
+    {
+        onChildAdded(snapshot, previousChildKey);
+        return;
+    }
+
+    if(addRoles(data.root()))
+    {
+        beginResetModel();
+        m_rows[row].node = data.root();
+        endResetModel();
+        return;
+    }
+
+    const QVector<int> roles = changedRoles(m_rows.at(row).node, data.root());
+    m_rows[row].node = data.root();
+    if(!roles.isEmpty())
+        emit dataChanged(index(row), index(row), roles);
+}
+
+void QtFirebaseDatabaseListModel::onChildMoved(QtFirebaseDataSnapshot *snapshot, const QString &previousChildKey)
+{
+    const QString key = snapshot->key();
+    const int from = indexOf(key);
+    if(from < 0)
+    {
+        onChildAdded(snapshot, previousChildKey);
+        return;
+    }
+
+    // Destination in the rows as they are before the move
+    const int to = rowAfter(previousChildKey);
+    if(to != from && to != from + 1)
+    {
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to);
+        const int target = to > from ? to - 1 : to;
+        m_rows.move(from, target);
+        reindex(qMin(from, target), qMax(from, target));
+        endMoveRows();
+    }
+    // Moves come with the data that caused them
+    onChildChanged(snapshot, previousChildKey);
+}
+
+void QtFirebaseDatabaseListModel::onChildRemoved(QtFirebaseDataSnapshot *snapshot)
+{
+    const QString key = snapshot->key();
+    const int row = indexOf(key);
+    if(row < 0)
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.remove(row);
+    m_index.remove(key);
+    reindex(row);
+    endRemoveRows();
+    emit countChanged();
+}
+
+int QtFirebaseDatabaseListModel::rowAfter(const QString &previousChildKey) const
+{
+    if(previousChildKey.isEmpty())
+        return 0;
+    const int previous = indexOf(previousChildKey);
+    return previous < 0 ? m_rows.size() : previous + 1;
+}
+
+void QtFirebaseDatabaseListModel::reindex(int from, int to)
+{
+    // NOTE only the index entries of shifted rows are touched, views never see this
+    if(to < 0 || to >= m_rows.size())
+        to = m_rows.size() - 1;
+    for(int i = from; i <= to; ++i)
+        m_index.insert(m_rows.at(i).key, i);
+}
+
+bool QtFirebaseDatabaseListModel::addRoles(const QtFirebaseSnapshotNode::Pointer &node)
+{
+    if(!node || !node->isMap())
+        return false;
+
+    bool added = false;
+    for(const QtFirebaseSnapshotNode::Child &child : node->children())
+    {
+        const QByteArray name = QByteArray::fromStdString(child.first);
+        // Names the delegates already have for something else stay reachable through "value"
+        if(name == "key" || name == "value" || name == "index" || name == "model" || name == "modelData")
+            continue;
+        if(!m_fields.contains(name))
+        {
+            m_fields.append(name);
+            added = true;
+        }
+    }
+    return added && m_rolesRead;
+}
+
+QVector<int> QtFirebaseDatabaseListModel::changedRoles(const QtFirebaseSnapshotNode::Pointer &before, const QtFirebaseSnapshotNode::Pointer &after) const
+{
+    QVector<int> roles;
+    if(QtFirebaseSnapshotNode::equals(before, after))
+        return roles;
+
+    roles.append(ValueRole);
+    const bool beforeMap = before && before->isMap();
+    const bool afterMap = after && after->isMap();
+    for(int i = 0; i < m_fields.size(); ++i)
+    {
+        const std::string name = m_fields.at(i).toStdString();
+        const QtFirebaseSnapshotNode::Pointer a = beforeMap ? before->child(name) : QtFirebaseSnapshotNode::Pointer();
+        const QtFirebaseSnapshotNode::Pointer b = afterMap ? after->child(name) : QtFirebaseSnapshotNode::Pointer();
+        if(!QtFirebaseSnapshotNode::equals(a, b))
+            roles.append(FirstFieldRole + i);
+    }
+    return roles;
 }
@@ -2,8 +2,20 @@
 #define QTFIREBASE_DATABASE_H
 
 #include "qtfirebaseservice.h"
+#include "qtfirebasebinding.h"
+#include "qtfirebasejson.h"
 #include "firebase/database.h"
+#include <QAbstractListModel>
+#include <QHash>
+#include <QJSValue>
 #include <QMutex>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <string>
+#include <utility>
+#include <vector>
 
 #ifdef QTFIREBASE_BUILD_DATABASE
 #include "src/qtfirebase.h"
@@ -13,21 +25,34 @@
 #define qFirebaseDatabase (static_cast<QtFirebaseDatabase*>(QtFirebaseDatabase::instance()))
 
 class QtFirebaseDatabaseRequest;
+class QtFirebaseDatabaseCache;
+class QtFirebaseSnapshotData;
 class QtFirebaseDatabase : public QtFirebaseService
 {
     Q_OBJECT
     typedef QSharedPointer<QtFirebaseDatabase> Ptr;
+    // Read cache of DatabaseRequest::exec(), keyed by location and filters. Results are reused
+    // for cacheTtl ms (0, the default, turns caching off), the least recently used ones are
+    // dropped beyond cacheBudget bytes. Identical reads running at the same time always share
+    // one download, the timeout of the first one applies
+    Q_PROPERTY(int cacheTtl READ cacheTtl WRITE setCacheTtl NOTIFY cacheTtlChanged)
+    Q_PROPERTY(int cacheBudget READ cacheBudget WRITE setCacheBudget NOTIFY cacheBudgetChanged)
+    Q_PROPERTY(int cacheBytes READ cacheBytes NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheHits READ cacheHits NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheMisses READ cacheMisses NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheCoalesced READ cacheCoalesced NOTIFY cacheStatsChanged)
 public:
     static QtFirebaseDatabase* instance() {
         if(self == 0) {
             self = new QtFirebaseDatabase(0);
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseDatabase) << self << "::instance" << "singleton";
         }
         return self;
     }
 
     enum Error
     {
+        ErrorTimeout = firebase::database::kErrorNone-1, // QtFirebase: the request timeout passed
         ErrorNone = firebase::database::kErrorNone,
         ErrorDisconnected = firebase::database::kErrorDisconnected,
         ErrorExpiredToken = firebase::database::kErrorExpiredToken,
@@ -46,58 +71,206 @@ public:
     };
     Q_ENUM(Error)
 
+    ~QtFirebaseDatabase();
+
+    int cacheTtl() const;
+    void setCacheTtl(int ttl);
+    int cacheBudget() const;
+    void setCacheBudget(int bytes);
+    int cacheBytes() const;
+    int cacheHits() const;
+    int cacheMisses() const;
+    int cacheCoalesced() const;
+public slots:
+    void clearCache();
+    // Drops what is cached at, above and below path. Writes through DatabaseRequest do this themselves
+    void invalidateCache(const QString& path);
+    void resetCacheStats();
+signals:
+    void cacheTtlChanged();
+    void cacheBudgetChanged();
+    void cacheStatsChanged();
+
     //TODO implement database related functions
     //(not important to write/read data for now but useful for extended control)
     //https://firebase.google.com/docs/reference/cpp/class/firebase/database/database
 private:
     explicit QtFirebaseDatabase(QObject *parent = 0);
     void init() override;
-    void onFutureEvent(QString eventId, firebase::FutureBase future) override;
 
-    QString futureKey(QtFirebaseDatabaseRequest* request) const;
-    QtFirebaseDatabaseRequest* request(const QString& futureKey) const;
-    void addFuture(QString requestId, QtFirebaseDatabaseRequest* request, firebase::FutureBase future);
+    void addFuture(const QString& action, QtFirebaseDatabaseRequest* request, const firebase::FutureBase& future);
     void unregisterRequest(QtFirebaseDatabaseRequest* request);
-    QString prefix() const;
+    // Answers from the cache or joins an identical read in flight, else starts one
+    void read(QtFirebaseDatabaseRequest* request, const QString& key, const QString& path,
+              firebase::database::Query query, bool ordered);
+    void finishRead(const QString& key, bool ordered, const QtFirebaseSnapshotData& previous, const firebase::FutureBase& future);
 private:
     static QtFirebaseDatabase* self;
     Q_DISABLE_COPY(QtFirebaseDatabase)
 
     firebase::database::Database* m_db;
-    QMap<QString, QtFirebaseDatabaseRequest*> m_requests;
+    // In-flight operations, every operation has its own future handle
+    QHash<QtFirebaseFutureHandle, QtFirebaseDatabaseRequest*> m_requests;
     QMutex m_futureMutex;
+    QScopedPointer<QtFirebaseDatabaseCache> m_cache;
+    int m_cacheHits;
+    int m_cacheMisses;
+    int m_cacheCoalesced;
 
     friend class QtFirebaseDatabaseRequest;
+    friend class QtFirebaseDatabaseListener;
+};
+
+/*
+ * Immutable snapshot tree with structural sharing
+ *
+ * Nodes never change once built and are reference counted, so they can be kept,
+ * copied and handed to other threads freely. A snapshot built against the previous
+ * one of the same location reuses every subtree that did not change: keeping the
+ * last N snapshots costs memory only for what changed between them, and equal
+ * subtrees can be recognized by pointer.
+ */
+class QtFirebaseSnapshotNode
+{
+public:
+    typedef QSharedPointer<const QtFirebaseSnapshotNode> Pointer;
+    typedef std::pair<std::string, Pointer> Child;
+
+    // Consumes value (leaves are moved into the nodes). Subtrees equal to the ones
+    // at the same place in previous are taken from there
+    static Pointer create(firebase::Variant&& value, const Pointer& previous = Pointer());
+
+    bool isMap() const;
+    bool isVector() const;
+    // Scalar value of leaves (null, bool, numbers, strings, blobs)
+    const firebase::Variant& leaf() const;
+    // Map children are sorted by key, vector children have empty keys (their position is the index)
+    const std::vector<Child>& children() const;
+    // Vectors take the index as key
+    Pointer child(const std::string& key) const;
+    // Position of key in children(), -1 if there is no such child
+    int indexOf(const std::string& key) const;
+    // Deep copy as a plain variant tree
+    firebase::Variant toVariant() const;
+
+    static bool equals(const Pointer& a, const Pointer& b);
+
+private:
+    enum Kind { Leaf, Map, Vector };
+    QtFirebaseSnapshotNode();
+
+    Kind m_kind;
+    firebase::Variant m_leaf;
+    std::vector<Child> m_children;
 };
 
+// Value type handle of one snapshot: cheap to copy, thread safe, never dangling
+class QtFirebaseSnapshotData
+{
+public:
+    QtFirebaseSnapshotData();
+    // Takes everything it needs from snapshot. Unchanged subtrees are shared with previous.
+    // For snapshots of ordered queries the order of the children is kept as well
+    explicit QtFirebaseSnapshotData(const firebase::database::DataSnapshot& snapshot,
+                                    const QtFirebaseSnapshotData& previous = QtFirebaseSnapshotData(),
+                                    bool ordered = false);
+    // Snapshot of a tree built elsewhere (child navigation, restored or generated data)
+    QtFirebaseSnapshotData(const QString& key, const QtFirebaseSnapshotNode::Pointer& root);
+
+    bool isValid() const;
+    bool exists() const;
+    QString key() const;
+    QtFirebaseSnapshotNode::Pointer root() const;
+    // Only known for snapshots delivered by the SDK, null for the ones navigated to
+    firebase::Variant priority() const;
+
+    // Navigation shares the subtree, nothing is copied or converted
+    QtFirebaseSnapshotNode::Pointer nodeAt(const QString& path) const;
+    QtFirebaseSnapshotData child(const QString& path) const;
+    // i-th child in the query's order, else in the location's (maps by key, arrays by index)
+    QtFirebaseSnapshotData childAt(int i) const;
+    int childrenCount() const;
+
+    // Same data, unchanged parts of successive snapshots compare by pointer
+    bool operator==(const QtFirebaseSnapshotData& other) const;
+    bool operator!=(const QtFirebaseSnapshotData& other) const;
+
+private:
+    QString m_key;
+    bool m_valid;
+    bool m_exists;
+    QtFirebaseSnapshotNode::Pointer m_root;
+    firebase::Variant m_priority;
+    // Positions in m_root->children() in query order, empty when that is the stored order
+    QVector<int> m_order;
+};
+Q_DECLARE_METATYPE(QtFirebaseSnapshotData)
+
 class QtFirebaseDataSnapshot: public QObject
 {
     Q_OBJECT
 public:
-    QtFirebaseDataSnapshot(const firebase::database::DataSnapshot& snapshot);
+    QtFirebaseDataSnapshot(const QtFirebaseSnapshotData& data, QObject* parent = nullptr);
 public slots:
     bool exists() const;
     QString key() const;
+    // Converted from the snapshot's nodes on first use and cached, the snapshot never changes
     QVariant value() const;
+    // Converts only the subtree at path (e.g. "users/42/name"), array elements are addressed by index.
+    // Cached per path like value()
+    QVariant valueAt(const QString& path) const;
+    // JS objects and arrays built straight in the calling engine, without a QVariantMap in between.
+    // Cached, every call returns the same object, treat it as read only
+    QJSValue jsValue() const;
+    QJSValue jsValueAt(const QString& path) const;
+    // NOTE value() and the JSON strings are maps, sorted by key. The ordered exports keep
+    // the order of the query: [{"key": ..., "value": ...}, ...]
     QByteArray jsonString() const;
+    QByteArray compactJsonString() const;
+    QVariantList orderedEntries() const;
+    QByteArray orderedJsonString() const;
+    QByteArray compactOrderedJsonString() const;
     bool hasChildren() const;
     bool valid() const;
+    // Same data as other, cheap for snapshots that share their trees
+    bool equals(QtFirebaseDataSnapshot* other) const;
 
-    //not implemented firebase functions
-    //
-    //currently can be accessed through qt json support (except priority), like
-    //QJsonDocument doc = QJsonDocument::fromVariant(request->getSnapshot().value());
-    //
-
-    /*
+    // Navigation without converting anything. Child snapshots share the parent's tree,
+    // are owned by it and are created once per path
     QtFirebaseDataSnapshot* child(const QString& path);
-    size_t childrenCount() const;
-    QtFirebaseDataSnapshot getChild(int i);
+    int childrenCount() const;
+    QtFirebaseDataSnapshot* getChild(int i);
     QVariant priority() const;
     bool hasChild(const QString& path) const;
-    */
+
+public:
+    // The shared data, e.g. to keep it after this object is gone or to pass it to another thread
+    QtFirebaseSnapshotData data() const;
+    // Streams the JSON to device (e.g. a QFile or QSaveFile) without building it in memory first
+    bool writeJson(QIODevice *device, QtFirebaseJson::Format format = QtFirebaseJson::Indented) const;
+    // Decodes into a described struct or gadget (see QtFirebaseBinding) without building QVariants,
+    // straight from the shared tree
+    template <typename T>
+    bool read(T &value) const
+    {
+        return readAt(QString(), value);
+    }
+    // Decodes only the subtree at path, like valueAt(). Missing paths leave value untouched
+    template <typename T>
+    bool readAt(const QString &path, T &value) const
+    {
+        const QtFirebaseSnapshotNode::Pointer node = m_data.nodeAt(path);
+        return !node || QtFirebaseBinding::decode(*node, value);
+    }
+
 private:
-    const firebase::database::DataSnapshot& m_snapshot;
+    void writeOrdered(QtFirebaseJsonWriter& writer) const;
+    QtFirebaseDataSnapshot* childSnapshot(const QString& path, const QtFirebaseSnapshotData& data);
+    QtFirebaseSnapshotData m_data;
+    // Keyed by path, value() is the empty one
+    mutable QHash<QString, QVariant> m_values;
+    mutable QHash<QString, QJSValue> m_jsValues;
+    QHash<QString, QtFirebaseDataSnapshot*> m_children;
 };
 
 class QtFirebaseDatabaseRequest;
@@ -123,20 +296,43 @@ public slots:
 signals:
     void run();
 private:
+    struct Filter
+    {
+        enum Kind { OrderByKey, OrderByValue, OrderByChild, OrderByPriority, StartAt, EndAt, EqualTo, LimitToFirst, LimitToLast };
+        Kind kind;
+        firebase::Variant value;
+        std::string text; // path of OrderByChild, child key of StartAt, EndAt and EqualTo
+        bool hasText;
+        size_t limit;
+    };
+    typedef std::vector<Filter> Filters;
+
     void clear();
     bool valid() const;
-    QtFirebaseDatabaseQuery* setQuery(const firebase::database::Query& query);
-    firebase::database::Query& query();
+    // Starts recording filters, unless a query is already being built
+    QtFirebaseDatabaseQuery* begin();
+    const Filters& filters() const;
+    // NOTE only recorded, the SDK query is built when it runs: the database may not be ready
+    // while filters are set up (e.g. from Component.onCompleted)
+    static firebase::database::Query build(const firebase::database::Query& base, const Filters& filters);
+    // The filters in the order they were applied, e.g. "orderByChild=time&limitToLast=50"
+    QString key() const;
+    void add(const Filter& filter, const QString& key);
+    static QString valueKey(const firebase::Variant& value);
 
     bool m_valid;
-    firebase::database::Query m_query;
+    Filters m_filters;
+    QString m_key;
     friend class QtFirebaseDatabaseRequest;
+    friend class QtFirebaseDatabaseListener;
 };
 
 class QtFirebaseDatabaseRequest: public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    // Milliseconds before a running operation fails with ErrorTimeout, 0 (default) waits forever
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
     Q_PROPERTY(QtFirebaseDataSnapshot* snapshot READ snapshot NOTIFY snapshotChanged)
 public:
     QtFirebaseDatabaseRequest();
@@ -166,6 +362,8 @@ public slots:
 
     //State
     bool running() const;
+    int timeout() const;
+    void setTimeout(int timeout);
     int errorId() const;
     bool hasError() const;
     QString errorMsg() const;
@@ -175,9 +373,16 @@ public slots:
     QtFirebaseDataSnapshot* snapshot();
 public:
     void onFutureEvent(QString eventId, firebase::FutureBase future);
+    // Writes from C++, e.g. setVariant(QtFirebaseBinding::encode(record)). Not overloads of
+    // setValue()/updateTree(): Variant converts implicitly from almost anything, calls would be ambiguous
+    void setVariant(const firebase::Variant& value);
+    // Bulk updates from C++: the JSON is parsed straight into the update, without QVariant trees
+    void updateTreeJson(const QByteArray& json);
+    void updateTreeJson(QIODevice* device);
 signals:
     void completed(bool success);
     void runningChanged();
+    void timeoutChanged();
     void snapshotChanged();
 private slots:
     void onRun();
@@ -185,15 +390,219 @@ private:
     void setComplete(bool value);
     void setError(int errId, const QString& msg = QString());
     void clearError();
+    void updateChildren(const firebase::Variant& tree);
+    void failUpdate(const QString& msg);
+    void onReadResult(const QtFirebaseSnapshotData& data, int errId, const QString& msg);
     QtFirebaseDatabaseQuery m_query;
     bool m_inComplexRequest;
     QtFirebaseDataSnapshot* m_snapshot;
+    bool m_ordered;
     firebase::database::DatabaseReference m_dbRef;
+    // Location of m_dbRef, normalized ("a/b", empty for the root)
+    QString m_path;
     QString m_action;
     bool m_complete;
+    int m_timeout;
     QString m_pushChildKey;
     int m_errId;
     QString m_errMsg;
+    friend class QtFirebaseDatabase;
+};
+
+class QtFirebaseDatabaseListenerBridge;
+/*
+ * Live updates of a location (path) or of a query on it
+ *
+ * Child events carry only the child that changed, value events the whole location
+ * (built against the previous value, unchanged subtrees are shared).
+ * Snapshot objects are only valid inside the signal handlers, keep their values
+ * (or data() from C++) instead of the objects.
+ *
+ *   DatabaseListener {
+ *       id: messages
+ *       path: "rooms/42/messages"
+ *       onChildAdded: list.append(snapshot.jsValue())
+ *   }
+ *   Component.onCompleted: messages.orderByChild("time").limitToLast(50).exec()   // or messages.start()
+ */
+class QtFirebaseDatabaseListener: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+    // Value events are off and child events on by default
+    Q_PROPERTY(bool valueEvents READ valueEvents WRITE setValueEvents NOTIFY valueEventsChanged)
+    Q_PROPERTY(bool childEvents READ childEvents WRITE setChildEvents NOTIFY childEventsChanged)
+    Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int errorId READ errorId NOTIFY cancelled)
+    Q_PROPERTY(QString errorMsg READ errorMsg NOTIFY cancelled)
+public:
+    QtFirebaseDatabaseListener(QObject* parent = nullptr);
+    ~QtFirebaseDatabaseListener();
+
+    QString path() const;
+    void setPath(const QString& path);
+    bool valueEvents() const;
+    void setValueEvents(bool value);
+    bool childEvents() const;
+    void setChildEvents(bool value);
+    bool active() const;
+    int errorId() const;
+    QString errorMsg() const;
+public slots:
+    // Listens to the whole location, or to the query built since the last start
+    void start();
+    void stop();
+
+    //Filters, exec() on the returned query starts listening to it
+    QtFirebaseDatabaseQuery* orderByKey();
+    QtFirebaseDatabaseQuery* orderByValue();
+    QtFirebaseDatabaseQuery* orderByChild(const QString& path);
+    QtFirebaseDatabaseQuery* orderByPriority();
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value);
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value);
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value);
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* limitToFirst(size_t limit);
+    QtFirebaseDatabaseQuery* limitToLast(size_t limit);
+signals:
+    void pathChanged();
+    void valueEventsChanged();
+    void childEventsChanged();
+    void activeChanged();
+    void valueChanged(QtFirebaseDataSnapshot* snapshot);
+    void childAdded(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childChanged(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childMoved(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childRemoved(QtFirebaseDataSnapshot* snapshot);
+    // The server ended the listening (e.g. permission denied), active is false again
+    void cancelled(int errorId, const QString& errorMsg);
+private slots:
+    void onDatabaseReadyChanged();
+private:
+    enum Event { ValueChanged, ChildAdded, ChildChanged, ChildMoved, ChildRemoved, Cancelled };
+    firebase::database::DatabaseReference reference() const;
+    void attach();
+    void detach();
+    void setActive(bool value);
+    void deliver(int generation, int event, const QtFirebaseSnapshotData& data, const QString& key, int errorId);
+
+    QString m_path;
+    bool m_valueEvents;
+    bool m_childEvents;
+    bool m_active;
+    bool m_wanted;
+    int m_generation;
+    int m_errId;
+    QString m_errMsg;
+    QtFirebaseDatabaseQuery m_query;
+    // Filters of the last query started, kept for re-attaching
+    QtFirebaseDatabaseQuery::Filters m_filters;
+    firebase::database::Query m_attached;
+    bool m_ordered;
+    QSharedPointer<QtFirebaseDatabaseListenerBridge> m_bridge;
+    friend class QtFirebaseDatabaseListenerBridge;
+};
+
+/*
+ * List model of the children of a location or query, kept in the query's order
+ *
+ * Child events are applied as row inserts, changes, moves and removals, so views
+ * only touch the delegates of the rows that changed. Roles are "key", "value"
+ * (the whole child) and one role per field of the children. Fields that show up
+ * after a view has read the roles reset the model once.
+ *
+ *   ListView {
+ *       model: DatabaseListModel {
+ *           id: messages
+ *           path: "rooms/42/messages"
+ *           Component.onCompleted: messages.orderByChild("time").limitToLast(100).exec()   // or start()
+ *       }
+ *       delegate: Text { text: author + ": " + text }
+ *   }
+ */
+class QtFirebaseDatabaseListModel: public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int errorId READ errorId NOTIFY cancelled)
+    Q_PROPERTY(QString errorMsg READ errorMsg NOTIFY cancelled)
+public:
+    enum Roles
+    {
+        KeyRole = Qt::UserRole + 1,
+        ValueRole,
+        FirstFieldRole
+    };
+
+    QtFirebaseDatabaseListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString path() const;
+    void setPath(const QString& path);
+    bool active() const;
+    int count() const;
+    int errorId() const;
+    QString errorMsg() const;
+
+    // Shared data of a row, e.g. for typed reads from C++
+    QtFirebaseSnapshotNode::Pointer node(int row) const;
+public slots:
+    void start();
+    void stop();
+    // Row of the child, -1 if there is none
+    int indexOf(const QString& key) const;
+    // The whole child at row
+    QVariant get(int row) const;
+
+    //Filters, exec() on the returned query (re)fills the model from it
+    QtFirebaseDatabaseQuery* orderByKey();
+    QtFirebaseDatabaseQuery* orderByValue();
+    QtFirebaseDatabaseQuery* orderByChild(const QString& path);
+    QtFirebaseDatabaseQuery* orderByPriority();
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value);
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value);
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value);
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value, const QString& child_key);
+    QtFirebaseDatabaseQuery* limitToFirst(size_t limit);
+    QtFirebaseDatabaseQuery* limitToLast(size_t limit);
+signals:
+    void pathChanged();
+    void activeChanged();
+    void countChanged();
+    void cancelled(int errorId, const QString& errorMsg);
+private slots:
+    void onActiveChanged();
+    void onChildAdded(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void onChildChanged(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void onChildMoved(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void onChildRemoved(QtFirebaseDataSnapshot* snapshot);
+private:
+    struct Row
+    {
+        QString key;
+        QtFirebaseSnapshotNode::Pointer node;
+    };
+    // Row following previousChildKey, as the child events place them
+    int rowAfter(const QString& previousChildKey) const;
+    void reindex(int from, int to = -1);
+    // Adds roles for new fields of node, true if a view may already have read the old roles
+    bool addRoles(const QtFirebaseSnapshotNode::Pointer& node);
+    QVector<int> changedRoles(const QtFirebaseSnapshotNode::Pointer& before, const QtFirebaseSnapshotNode::Pointer& after) const;
+
+    QtFirebaseDatabaseListener m_listener;
+    QVector<Row> m_rows;
+    QHash<QString, int> m_index;
+    QVector<QByteArray> m_fields;
+    mutable bool m_rolesRead;
 };
 
 #endif //QTFIREBASE_BUILD_DATABASE
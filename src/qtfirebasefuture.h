@@ -0,0 +1,181 @@
+#ifndef QTFIREBASE_FUTURE_H
+#define QTFIREBASE_FUTURE_H
+
+#include "qtfirebase.h"
+
+#include "firebase/future.h"
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QMetaObject>
+#include <QPointer>
+
+#ifndef QT_NO_EXCEPTIONS
+#include <QException>
+#endif
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define QTFIREBASE_HAS_COROUTINES
+#endif
+#endif
+
+/*
+ * Adapters from firebase::Future<T> to QFuture<T>, Qt continuations and C++20 coroutines
+ *
+ * Completion is driven by QtFirebase (no polling, no nested event loops).
+ * All adapters must be created on the QtFirebase (GUI) thread, continuations
+ * run on the thread of the given context object.
+ *
+ * Example:
+ *
+ *   QtFirebaseFuture::then(ref.GetValue(), this, [this](const firebase::Future<DataSnapshot> &future) {
+ *       if(future.error() == firebase::database::kErrorNone)
+ *           use(*future.result());
+ *   });
+ *
+ *   // In a coroutine
+ *   auto future = co_await QtFirebaseFuture::await(ref.GetValue(), this);
+ */
+
+#ifndef QT_NO_EXCEPTIONS
+// Reported through QFuture when the firebase future fails, rethrown by QFuture::result()/waitForFinished()
+class QtFirebaseFutureException : public QException
+{
+public:
+    QtFirebaseFutureException(int error, const QString &message) : m_error(error), m_message(message) {}
+
+    void raise() const override { throw *this; }
+    QtFirebaseFutureException *clone() const override { return new QtFirebaseFutureException(*this); }
+
+    int error() const { return m_error; }
+    QString message() const { return m_message; }
+
+private:
+    int m_error;
+    QString m_message;
+};
+#endif
+
+class QtFirebaseFuture
+{
+public:
+    // QFuture finishing when the firebase future does.
+    // A failed or invalid firebase future finishes the QFuture with a QtFirebaseFutureException
+    // (or canceled when built without exceptions)
+    template <typename T>
+    static QFuture<T> toQFuture(const firebase::Future<T> &future)
+    {
+        QFutureInterface<T> promise;
+        promise.reportStarted();
+
+        qFirebase->addFuture(future, [promise](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) mutable {
+            Q_UNUSED(handle)
+            if(!failed(promise, completed))
+                report(promise, completed);
+            promise.reportFinished();
+        });
+
+        return promise.future();
+    }
+
+    // Calls continuation(const firebase::Future<T> &) on the thread of context once the future is done.
+    // Nothing is called if context is destroyed before that
+    template <typename T, typename Continuation>
+    static void then(const firebase::Future<T> &future, QObject *context, Continuation continuation)
+    {
+        QPointer<QObject> guard(context);
+        qFirebase->addFuture(future, [guard, continuation](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+            Q_UNUSED(handle)
+            if(!guard)
+                return;
+
+            const firebase::Future<T> result(static_cast<const firebase::Future<T> &>(completed));
+            if(guard->thread() == qFirebase->thread())
+                continuation(result);
+            else
+                QMetaObject::invokeMethod(guard.data(), [continuation, result]() { continuation(result); }, Qt::QueuedConnection);
+        });
+    }
+
+#ifdef QTFIREBASE_HAS_COROUTINES
+    template <typename T>
+    class Awaitable
+    {
+    public:
+        Awaitable(const firebase::Future<T> &future, QObject *context) : m_future(future), m_context(context), m_hasContext(context != nullptr) {}
+
+        bool await_ready() const
+        {
+            return m_future.status() != firebase::kFutureStatusPending;
+        }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            // Without a context the coroutine resumes on the QtFirebase thread.
+            // If the context dies while suspended the coroutine is never resumed
+            QPointer<QObject> context = m_context;
+            const bool hasContext = m_hasContext;
+            qFirebase->addFuture(m_future, [coroutine, context, hasContext](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+                Q_UNUSED(handle)
+                Q_UNUSED(completed)
+                if(!hasContext)
+                    coroutine.resume();
+                else if(context)
+                    QMetaObject::invokeMethod(context.data(), [coroutine]() { coroutine.resume(); }, Qt::QueuedConnection);
+            });
+        }
+
+        // Check error() / result() on the returned future
+        firebase::Future<T> await_resume() const
+        {
+            return m_future;
+        }
+
+    private:
+        firebase::Future<T> m_future;
+        QPointer<QObject> m_context;
+        bool m_hasContext;
+    };
+
+    template <typename T>
+    static Awaitable<T> await(const firebase::Future<T> &future, QObject *context = nullptr)
+    {
+        return Awaitable<T>(future, context);
+    }
+#endif // QTFIREBASE_HAS_COROUTINES
+
+private:
+    template <typename T>
+    static bool failed(QFutureInterface<T> &promise, const firebase::FutureBase &completed)
+    {
+        if(completed.status() == firebase::kFutureStatusComplete && completed.error() == 0)
+            return false;
+
+#ifndef QT_NO_EXCEPTIONS
+        const int error = completed.status() == firebase::kFutureStatusComplete ? completed.error() : -1;
+        const char *message = completed.status() == firebase::kFutureStatusComplete ? completed.error_message() : nullptr;
+        promise.reportException(QtFirebaseFutureException(error, QString::fromUtf8(message ? message : "")));
+#else
+        promise.reportCanceled();
+#endif
+        return true;
+    }
+
+    template <typename T>
+    static void report(QFutureInterface<T> &promise, const firebase::FutureBase &completed)
+    {
+        const T *result = static_cast<const T *>(completed.result_void());
+        if(result)
+            promise.reportResult(*result);
+    }
+
+    static void report(QFutureInterface<void> &promise, const firebase::FutureBase &completed)
+    {
+        Q_UNUSED(promise)
+        Q_UNUSED(completed)
+    }
+};
+
+#endif // QTFIREBASE_FUTURE_H
@@ -0,0 +1,154 @@
+#include "qtfirebasefutureregistry.h"
+
+namespace {
+    // Table capacity is always a power of two and kept at most half full
+    const int MinimumCapacity = 16;
+}
+
+QtFirebaseFutureRegistry::QtFirebaseFutureRegistry():
+    m_size(0),
+    m_nextHandle(1)
+{
+}
+
+QtFirebaseFutureHandle QtFirebaseFutureRegistry::insert(const firebase::FutureBase &future, const Callback &callback, int operation, qint64 started)
+{
+    if((m_size + 1) * 2 > m_table.size())
+        grow();
+
+    Entry entry;
+    entry.handle = m_nextHandle++;
+    entry.future = future;
+    entry.callback = callback;
+    entry.operation = operation;
+    entry.started = started;
+
+    const QtFirebaseFutureHandle handle = entry.handle;
+    place(std::move(entry));
+    m_size++;
+    return handle;
+}
+
+bool QtFirebaseFutureRegistry::remove(QtFirebaseFutureHandle handle)
+{
+    const int index = indexOf(handle);
+    if(index < 0)
+        return false;
+
+    removeAt(index);
+    return true;
+}
+
+bool QtFirebaseFutureRegistry::take(QtFirebaseFutureHandle handle, Entry &entry)
+{
+    const int index = indexOf(handle);
+    if(index < 0)
+        return false;
+
+    entry = std::move(m_table[index]);
+    removeAt(index);
+    return true;
+}
+
+bool QtFirebaseFutureRegistry::contains(QtFirebaseFutureHandle handle) const
+{
+    return indexOf(handle) >= 0;
+}
+
+int QtFirebaseFutureRegistry::size() const
+{
+    return m_size;
+}
+
+bool QtFirebaseFutureRegistry::isEmpty() const
+{
+    return m_size == 0;
+}
+
+void QtFirebaseFutureRegistry::takeCompleted(QVector<Entry> &completed)
+{
+    if(m_size == 0)
+        return;
+
+    const int first = completed.size();
+    for(int i = 0; i < m_table.size(); ++i)
+    {
+        const Entry &entry = m_table.at(i);
+        if(entry.handle != 0 && entry.future.status() != firebase::kFutureStatusPending)
+            completed.append(entry);
+    }
+
+    // Removing while scanning would shift not yet visited entries around, so do it afterwards
+    for(int i = first; i < completed.size(); ++i)
+        remove(completed.at(i).handle);
+}
+
+int QtFirebaseFutureRegistry::indexOf(QtFirebaseFutureHandle handle) const
+{
+    if(handle == 0 || m_size == 0)
+        return -1;
+
+    const int mask = m_table.size() - 1;
+    for(int i = homeIndex(handle);; i = (i + 1) & mask)
+    {
+        const QtFirebaseFutureHandle current = m_table.at(i).handle;
+        if(current == handle)
+            return i;
+        if(current == 0)
+            return -1;
+    }
+}
+
+int QtFirebaseFutureRegistry::homeIndex(QtFirebaseFutureHandle handle) const
+{
+    // Handles are sequential, so mix the bits before masking (splitmix64 finalizer)
+    quint64 h = handle;
+    h ^= h >> 30;
+    h *= Q_UINT64_C(0xbf58476d1ce4e5b9);
+    h ^= h >> 27;
+    h *= Q_UINT64_C(0x94d049bb133111eb);
+    h ^= h >> 31;
+    return static_cast<int>(h & static_cast<quint64>(m_table.size() - 1));
+}
+
+void QtFirebaseFutureRegistry::place(Entry &&entry)
+{
+    const int mask = m_table.size() - 1;
+    int i = homeIndex(entry.handle);
+    while(m_table.at(i).handle != 0)
+        i = (i + 1) & mask;
+    m_table[i] = std::move(entry);
+}
+
+void QtFirebaseFutureRegistry::removeAt(int index)
+{
+    // Backward shift deletion: pull later entries of the probe run into the hole
+    // so lookups never need tombstones
+    const int mask = m_table.size() - 1;
+    int hole = index;
+    for(int i = (hole + 1) & mask; m_table.at(i).handle != 0; i = (i + 1) & mask)
+    {
+        const int home = homeIndex(m_table.at(i).handle);
+        const bool inRun = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if(inRun)
+            continue;
+
+        m_table[hole] = std::move(m_table[i]);
+        hole = i;
+    }
+    m_table[hole] = Entry();
+    m_size--;
+}
+
+void QtFirebaseFutureRegistry::grow()
+{
+    QVector<Entry> old;
+    old.swap(m_table);
+    m_table.resize(qMax(MinimumCapacity, old.size() * 2));
+
+    for(int i = 0; i < old.size(); ++i)
+    {
+        if(old.at(i).handle != 0)
+            place(std::move(old[i]));
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef QTFIREBASE_FUTURE_REGISTRY_H
+#define QTFIREBASE_FUTURE_REGISTRY_H
+
+#include "firebase/future.h"
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <functional>
+
+typedef quint64 QtFirebaseFutureHandle;
+
+/*
+ * Pending futures keyed by 64-bit handles
+ *
+ * Entries are kept in a flat open addressing table (linear probing with backward
+ * shift deletion) together with the callback that should receive the result.
+ * Handles are never reused, 0 is never a valid handle.
+ */
+class QtFirebaseFutureRegistry
+{
+public:
+    typedef std::function<void(QtFirebaseFutureHandle handle, const firebase::FutureBase &future)> Callback;
+
+    struct Entry
+    {
+        QtFirebaseFutureHandle handle = 0;
+        firebase::FutureBase future;
+        Callback callback;
+        int operation = -1; // QtFirebaseMetrics::Operation, -1 when not measured
+        qint64 started = 0;
+    };
+
+    QtFirebaseFutureRegistry();
+
+    QtFirebaseFutureHandle insert(const firebase::FutureBase &future, const Callback &callback, int operation = -1, qint64 started = 0);
+    bool remove(QtFirebaseFutureHandle handle);
+    bool take(QtFirebaseFutureHandle handle, Entry &entry);
+    bool contains(QtFirebaseFutureHandle handle) const;
+
+    int size() const;
+    bool isEmpty() const;
+
+    // Moves every entry whose future is no longer pending to 'completed'
+    void takeCompleted(QVector<Entry> &completed);
+
+private:
+    int indexOf(QtFirebaseFutureHandle handle) const;
+    int homeIndex(QtFirebaseFutureHandle handle) const;
+    void place(Entry &&entry);
+    void removeAt(int index);
+    void grow();
+
+    QVector<Entry> m_table;
+    int m_size;
+    QtFirebaseFutureHandle m_nextHandle;
+};
+
+#endif // QTFIREBASE_FUTURE_REGISTRY_H
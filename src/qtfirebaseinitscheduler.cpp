@@ -0,0 +1,170 @@
+#include "qtfirebaseinitscheduler.h"
+#include "qtfirebaselogging.h"
+
+#include <QMetaObject>
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace {
+    class InitRunnable : public QRunnable
+    {
+    public:
+        typedef std::function<void(const QtFirebaseInitScheduler::Task &)> Done;
+
+        InitRunnable(const QtFirebaseInitScheduler::Work &work, const Done &done) :
+            m_work(work),
+            m_done(done)
+        {
+        }
+
+        void run() override
+        {
+            m_done(m_work());
+        }
+
+    private:
+        QtFirebaseInitScheduler::Work m_work;
+        Done m_done;
+    };
+}
+
+QtFirebaseInitScheduler::QtFirebaseInitScheduler(QObject *parent) :
+    QObject(parent),
+    m_nextId(0),
+    m_allReady(false)
+{
+}
+
+void QtFirebaseInitScheduler::addModule(const QString &module, Affinity affinity, const Work &work, QObject *receiver, const Task &finished, const QStringList &dependencies)
+{
+    const quint64 id = ++m_nextId;
+    Node &node = m_nodes[id];
+    node.module = module;
+    node.affinity = affinity;
+    node.work = work;
+    node.receiver = receiver;
+    node.finished = finished;
+    node.dependencies = dependencies;
+
+    // A second instance of a module that is ready already does not change allReady
+    if(!isReady(module))
+        updateAllReady();
+
+    if(dependenciesReady(node))
+        start(id);
+}
+
+void QtFirebaseInitScheduler::markReady(const QString &module)
+{
+    // Modules that were never added (the App itself, AdMob) are plain milestones
+    if(m_ready.contains(module))
+        return;
+
+    m_ready.insert(module);
+    emit moduleReady(module);
+
+    // Everything that was only waiting for this module starts now, at the same time
+    QList<quint64> startable;
+    for(auto it = m_nodes.constBegin(); it != m_nodes.constEnd(); ++it) {
+        const Node &dependent = it.value();
+        if(!dependent.started && dependent.dependencies.contains(module) && dependenciesReady(dependent))
+            startable << it.key();
+    }
+    for(quint64 id : startable)
+        start(id);
+
+    updateAllReady();
+}
+
+bool QtFirebaseInitScheduler::isReady(const QString &module) const
+{
+    return m_ready.contains(module);
+}
+
+bool QtFirebaseInitScheduler::allReady() const
+{
+    return m_allReady;
+}
+
+bool QtFirebaseInitScheduler::dependenciesReady(const Node &node) const
+{
+    for(const QString &dependency : node.dependencies) {
+        if(!isReady(dependency))
+            return false;
+    }
+    return true;
+}
+
+void QtFirebaseInitScheduler::start(quint64 id)
+{
+    Node &node = m_nodes[id];
+    node.started = true;
+
+    qtfbDebug(lcQtFirebase) << this << "::start" << node.module << (node.affinity == AnyThread && node.work ? "on pool thread" : "on GUI thread");
+
+    if(node.affinity == AnyThread && node.work) {
+        // The scheduler outlives the pool task (it belongs to QtFirebase), the receiver might not.
+        // The result is only applied in finish(), on the GUI thread, if the receiver still exists
+        QThreadPool::globalInstance()->start(new InitRunnable(node.work, [this, id](const Task &result) {
+            QMetaObject::invokeMethod(this, [this, id, result]() { finish(id, result); }, Qt::QueuedConnection);
+        }));
+        return;
+    }
+
+    // Run on the next event loop iteration, modules are usually added from their constructor
+    // and need it to return before emitting readyChanged
+    QMetaObject::invokeMethod(this, [this, id]() {
+        const Node queued = m_nodes.value(id);
+        finish(id, queued.receiver && queued.work ? queued.work() : Task());
+    }, Qt::QueuedConnection);
+}
+
+void QtFirebaseInitScheduler::finish(quint64 id, const Task &result)
+{
+    auto it = m_nodes.find(id);
+    if(it == m_nodes.end())
+        return;
+
+    const Node node = it.value();
+    if(!node.receiver) {
+        qtfbDebug(lcQtFirebase) << this << "::finish" << node.module << "was destroyed during initialization";
+        m_nodes.erase(it);
+        updateAllReady();
+        return;
+    }
+
+    it.value().done = true;
+    if(result)
+        result();
+    if(node.finished)
+        node.finished();
+
+    // Another instance may have made the module ready in the meantime
+    if(isReady(node.module))
+        updateAllReady();
+}
+
+void QtFirebaseInitScheduler::updateAllReady()
+{
+    bool allReady = isReady(QStringLiteral("QtFirebase"));
+    for(auto it = m_nodes.begin(); it != m_nodes.end();) {
+        const Node &node = it.value();
+        if(isReady(node.module) && node.done) {
+            it = m_nodes.erase(it);
+            continue;
+        }
+        // A destroyed instance no longer holds the others up, its pending finish() is a no-op
+        if(!node.receiver) {
+            it = m_nodes.erase(it);
+            continue;
+        }
+        if(!isReady(node.module))
+            allReady = false;
+        ++it;
+    }
+
+    if(m_allReady != allReady) {
+        m_allReady = allReady;
+        emit allReadyChanged();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef QTFIREBASE_INIT_SCHEDULER_H
+#define QTFIREBASE_INIT_SCHEDULER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+
+#include <functional>
+
+/*
+ * Startup dependency graph of the QtFirebase modules
+ *
+ * Every module instance is a node that waits for its dependencies (by default
+ * only the Firebase App, module "QtFirebase") to become ready. All nodes whose
+ * dependencies are met start at the same time: AnyThread work runs on the global
+ * QThreadPool, the 'finished' step always runs on the GUI thread afterwards.
+ * Readiness is tracked per module name, reported through markReady(), which is
+ * what QtFirebase::recordStartup() does. Several instances of the same module
+ * (QML items created twice, or again after their page was destroyed) each get
+ * their own node, a late one starts right away when its dependencies are ready.
+ *
+ * Must only be used from the GUI thread.
+ */
+class QtFirebaseInitScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Affinity
+    {
+        GuiThread,
+        AnyThread // 'work' may run off the GUI thread, the SDK call must be thread safe
+    };
+
+    typedef std::function<void()> Task;
+    // Returns what is left to do on the GUI thread with the result (may be empty). It runs
+    // right before 'finished' and only if the receiver still exists, so it is the place to
+    // store SDK handles in the receiver: 'work' itself must not touch it on a pool thread
+    typedef std::function<Task()> Work;
+
+    explicit QtFirebaseInitScheduler(QObject *parent = nullptr);
+
+    // 'work' (may be empty) runs first, then 'finished' on the GUI thread unless receiver is gone by then
+    void addModule(const QString &module, Affinity affinity, const Work &work, QObject *receiver, const Task &finished,
+                   const QStringList &dependencies = QStringList() << QStringLiteral("QtFirebase"));
+    void markReady(const QString &module);
+
+    bool isReady(const QString &module) const;
+    // True once every added module is ready
+    bool allReady() const;
+
+signals:
+    void moduleReady(const QString &module);
+    void allReadyChanged();
+
+private:
+    struct Node
+    {
+        QString module;
+        Affinity affinity = GuiThread;
+        Work work;
+        QPointer<QObject> receiver;
+        Task finished;
+        QStringList dependencies;
+        bool started = false;
+        bool done = false; // finished step ran, waiting for markReady()
+    };
+
+    bool dependenciesReady(const Node &node) const;
+    void start(quint64 id);
+    void finish(quint64 id, const Task &result);
+    void updateAllReady();
+
+    // Nodes by registration, dropped once their module is ready or their receiver is gone
+    QHash<quint64, Node> m_nodes;
+    QSet<QString> m_ready;
+    quint64 m_nextId;
+    bool m_allReady;
+};
+
+#endif // QTFIREBASE_INIT_SCHEDULER_H
@@ -0,0 +1,883 @@
+#include "qtfirebasejson.h"
+#include "qtfirebaselogging.h"
+
+#include <QFileDevice>
+#include <QIODevice>
+#include <QLocale>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+    const int DeviceBufferSize = 64 * 1024;
+
+    class ByteArraySink
+    {
+    public:
+        explicit ByteArraySink(QByteArray &out) : m_out(out) {}
+
+        void append(const char *data, int size) { m_out.append(data, size); }
+        void append(char c) { m_out.append(c); }
+
+    private:
+        QByteArray &m_out;
+    };
+
+    class DeviceSink
+    {
+    public:
+        explicit DeviceSink(QIODevice *device) : m_device(device), m_ok(true)
+        {
+            m_buffer.reserve(DeviceBufferSize);
+        }
+
+        void append(const char *data, int size)
+        {
+            if(m_buffer.size() + size > DeviceBufferSize)
+                flush();
+            if(size > DeviceBufferSize)
+                write(data, size);
+            else
+                m_buffer.append(data, size);
+        }
+
+        void append(char c)
+        {
+            if(m_buffer.size() >= DeviceBufferSize)
+                flush();
+            m_buffer.append(c);
+        }
+
+        bool flush()
+        {
+            if(!m_buffer.isEmpty()) {
+                write(m_buffer.constData(), m_buffer.size());
+                m_buffer.resize(0); // keeps the capacity
+            }
+            return m_ok;
+        }
+
+    private:
+        void write(const char *data, int size)
+        {
+            if(m_ok && m_device->write(data, size) != size)
+                m_ok = false;
+        }
+
+        QIODevice *m_device;
+        QByteArray m_buffer;
+        bool m_ok;
+    };
+
+    bool isString(const firebase::Variant &v)
+    {
+        return v.type() == firebase::Variant::kTypeStaticString || v.type() == firebase::Variant::kTypeMutableString;
+    }
+
+    void stringData(const firebase::Variant &v, const char *&data, int &size)
+    {
+        if(v.type() == firebase::Variant::kTypeMutableString) {
+            const std::string &str = v.mutable_string();
+            data = str.data();
+            size = static_cast<int>(str.size());
+        } else {
+            data = v.string_value();
+            size = static_cast<int>(std::strlen(data));
+        }
+    }
+
+    // Rough output size, only used to size the result once instead of growing it repeatedly
+    int estimateSize(const firebase::Variant &v, int indent, bool compact)
+    {
+        switch(v.type()) {
+        case firebase::Variant::kTypeStaticString:
+        case firebase::Variant::kTypeMutableString: {
+            const char *data;
+            int size;
+            stringData(v, data, size);
+            return size + 2;
+        }
+        case firebase::Variant::kTypeMap: {
+            const int entryOverhead = compact ? 4 : 4 * (indent + 1) + 6;
+            int size = 2 + (compact ? 0 : 4 * indent + 2);
+            for(const auto &entry : v.map())
+                size += estimateSize(entry.first, indent + 1, compact) + estimateSize(entry.second, indent + 1, compact) + entryOverhead;
+            return size;
+        }
+        case firebase::Variant::kTypeVector: {
+            const int entryOverhead = compact ? 1 : 4 * (indent + 1) + 2;
+            int size = 2 + (compact ? 0 : 4 * indent + 2);
+            for(const firebase::Variant &item : v.vector())
+                size += estimateSize(item, indent + 1, compact) + entryOverhead;
+            return size;
+        }
+        default:
+            return 8;
+        }
+    }
+
+    template <typename Sink>
+    class JsonWriter
+    {
+    public:
+        JsonWriter(Sink &sink, bool compact) : m_sink(sink), m_compact(compact) {}
+
+        void value(const firebase::Variant &v, int indent)
+        {
+            switch(v.type()) {
+            case firebase::Variant::kTypeInt64: {
+                char buffer[24];
+                const int size = qsnprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(v.int64_value()));
+                m_sink.append(buffer, size);
+                break;
+            }
+            case firebase::Variant::kTypeDouble:
+                number(v.double_value());
+                break;
+            case firebase::Variant::kTypeBool:
+                if(v.bool_value())
+                    m_sink.append("true", 4);
+                else
+                    m_sink.append("false", 5);
+                break;
+            case firebase::Variant::kTypeStaticString:
+            case firebase::Variant::kTypeMutableString:
+                string(v);
+                break;
+            case firebase::Variant::kTypeMap:
+                object(v, indent);
+                break;
+            case firebase::Variant::kTypeVector:
+                array(v, indent);
+                break;
+            default:
+                m_sink.append("null", 4);
+                break;
+            }
+        }
+
+        // Pieces of objects and arrays, also used by QtFirebaseJsonWriter
+        void begin(char bracket)
+        {
+            const char text[] = { bracket, '\n' };
+            m_sink.append(text, m_compact ? 1 : 2);
+        }
+
+        // Before every entry of a container at indent
+        void item(bool first, int indent)
+        {
+            if(!first)
+                m_sink.append(m_compact ? "," : ",\n", m_compact ? 1 : 2);
+            if(!m_compact)
+                newlineIndent(indent + 1);
+        }
+
+        void key(const char *data, int size)
+        {
+            string(data, size);
+            m_sink.append(m_compact ? ":" : ": ", m_compact ? 1 : 2);
+        }
+
+        void end(char bracket, bool empty, int indent)
+        {
+            if(!empty && !m_compact)
+                m_sink.append('\n');
+            if(!m_compact)
+                newlineIndent(indent);
+            m_sink.append(bracket);
+        }
+
+    private:
+        void newlineIndent(int indent)
+        {
+            static const char spaces[] = "                                                                ";
+            int count = 4 * indent;
+            while(count > 0) {
+                const int chunk = qMin(count, static_cast<int>(sizeof(spaces)) - 1);
+                m_sink.append(spaces, chunk);
+                count -= chunk;
+            }
+        }
+
+        void object(const firebase::Variant &v, int indent)
+        {
+            begin('{');
+            bool first = true;
+            for(const auto &entry : v.map()) {
+                if(!isString(entry.first)) {
+                    qCWarning(lcQtFirebase) << "QtFirebaseJson: skipping non string key of type" << firebase::Variant::TypeName(entry.first.type());
+                    continue;
+                }
+                const char *data;
+                int size;
+                stringData(entry.first, data, size);
+                item(first, indent);
+                key(data, size);
+                first = false;
+                value(entry.second, indent + 1);
+            }
+            end('}', first, indent);
+        }
+
+        void array(const firebase::Variant &v, int indent)
+        {
+            const std::vector<firebase::Variant> &vector = v.vector();
+            begin('[');
+            for(size_t i = 0; i < vector.size(); ++i) {
+                item(i == 0, indent);
+                value(vector[i], indent + 1);
+            }
+            end(']', vector.empty(), indent);
+        }
+
+        void number(double d)
+        {
+            if(!std::isfinite(d)) {
+                m_sink.append("null", 4);
+                return;
+            }
+            // Same formatting as QJsonDocument: integral values without exponent
+            const double abs = std::abs(d);
+            const bool integral = abs < 18446744073709551616.0 && abs == static_cast<double>(static_cast<quint64>(abs));
+            const QByteArray text = QByteArray::number(d, integral ? 'f' : 'g', QLocale::FloatingPointShortest);
+            m_sink.append(text.constData(), text.size());
+        }
+
+        void string(const firebase::Variant &v)
+        {
+            const char *data;
+            int size;
+            stringData(v, data, size);
+            string(data, size);
+        }
+
+        void string(const char *data, int size)
+        {
+            static const char hex[] = "0123456789abcdef";
+
+            m_sink.append('"');
+            // Copy runs of plain bytes in one go, UTF-8 sequences pass through unchanged
+            int run = 0;
+            for(int i = 0; i < size; ++i) {
+                const unsigned char c = static_cast<unsigned char>(data[i]);
+                if(c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+
+                m_sink.append(data + run, i - run);
+                run = i + 1;
+
+                switch(c) {
+                case '"': m_sink.append("\\\"", 2); break;
+                case '\\': m_sink.append("\\\\", 2); break;
+                case '\b': m_sink.append("\\b", 2); break;
+                case '\f': m_sink.append("\\f", 2); break;
+                case '\n': m_sink.append("\\n", 2); break;
+                case '\r': m_sink.append("\\r", 2); break;
+                case '\t': m_sink.append("\\t", 2); break;
+                default: {
+                    const char escape[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                    m_sink.append(escape, 6);
+                }
+                }
+            }
+            m_sink.append(data + run, size - run);
+            m_sink.append('"');
+        }
+
+        Sink &m_sink;
+        bool m_compact;
+    };
+
+    template <typename Sink>
+    void writeDocument(Sink &sink, const firebase::Variant &variant, QtFirebaseJson::Format format)
+    {
+        const bool compact = format == QtFirebaseJson::Compact;
+        JsonWriter<Sink> writer(sink, compact);
+        writer.value(variant, 0);
+
+        // QJsonDocument ends indented documents with a newline
+        if(!compact && (variant.is_map() || variant.is_vector()))
+            sink.append('\n');
+    }
+}
+
+namespace {
+    // Either of the two sinks, picked at run time
+    class WriterSink
+    {
+    public:
+        WriterSink(QByteArray *out, QIODevice *device) : m_out(out), m_device(device ? new DeviceSink(device) : nullptr) {}
+
+        void append(const char *data, int size)
+        {
+            if(m_device)
+                m_device->append(data, size);
+            else
+                m_out->append(data, size);
+        }
+
+        void append(char c)
+        {
+            if(m_device)
+                m_device->append(c);
+            else
+                m_out->append(c);
+        }
+
+        bool flush() { return !m_device || m_device->flush(); }
+
+    private:
+        QByteArray *m_out;
+        QScopedPointer<DeviceSink> m_device;
+    };
+}
+
+class QtFirebaseJsonWriter::Private
+{
+public:
+    Private(QByteArray *out, QIODevice *device, QtFirebaseJson::Format format) :
+        sink(out, device),
+        writer(sink, format == QtFirebaseJson::Compact),
+        compact(format == QtFirebaseJson::Compact),
+        container(false),
+        ok(device == nullptr || device->isWritable())
+    {
+    }
+
+    // Separator and indentation for array items, object entries get theirs in key()
+    void beforeValue()
+    {
+        if(levels.isEmpty() || !levels.last().array)
+            return;
+        writer.item(levels.last().empty, levels.size() - 1);
+        levels.last().empty = false;
+    }
+
+    void begin(char bracket, bool array)
+    {
+        beforeValue();
+        writer.begin(bracket);
+        levels.append(Level{array, true});
+    }
+
+    void end(char bracket)
+    {
+        if(levels.isEmpty()) {
+            qCWarning(lcQtFirebase) << "QtFirebaseJsonWriter: unbalanced" << bracket;
+            return;
+        }
+        writer.end(bracket, levels.last().empty, levels.size() - 1);
+        levels.removeLast();
+        container = levels.isEmpty();
+    }
+
+    struct Level
+    {
+        bool array;
+        bool empty;
+    };
+
+    WriterSink sink;
+    JsonWriter<WriterSink> writer;
+    QVector<Level> levels;
+    bool compact;
+    bool container; // the document is an object or array
+    bool ok;
+};
+
+QtFirebaseJsonWriter::QtFirebaseJsonWriter(QByteArray *out, QtFirebaseJson::Format format) :
+    d(new Private(out, nullptr, format))
+{
+}
+
+QtFirebaseJsonWriter::QtFirebaseJsonWriter(QIODevice *device, QtFirebaseJson::Format format) :
+    d(new Private(nullptr, device, format))
+{
+    if(!d->ok)
+        qCWarning(lcQtFirebase) << "QtFirebaseJsonWriter" << "device is not writable";
+}
+
+QtFirebaseJsonWriter::~QtFirebaseJsonWriter()
+{
+}
+
+void QtFirebaseJsonWriter::beginObject()
+{
+    d->begin('{', false);
+}
+
+void QtFirebaseJsonWriter::endObject()
+{
+    d->end('}');
+}
+
+void QtFirebaseJsonWriter::beginArray()
+{
+    d->begin('[', true);
+}
+
+void QtFirebaseJsonWriter::endArray()
+{
+    d->end(']');
+}
+
+void QtFirebaseJsonWriter::key(const char *data, int size)
+{
+    Q_ASSERT(!d->levels.isEmpty() && !d->levels.last().array);
+    d->writer.item(d->levels.last().empty, d->levels.size() - 1);
+    d->levels.last().empty = false;
+    d->writer.key(data, size);
+}
+
+void QtFirebaseJsonWriter::value(const firebase::Variant &value)
+{
+    d->beforeValue();
+    d->writer.value(value, d->levels.size());
+    if(d->levels.isEmpty())
+        d->container = value.is_map() || value.is_vector();
+}
+
+bool QtFirebaseJsonWriter::finish()
+{
+    // QJsonDocument ends indented documents with a newline
+    if(!d->compact && d->container)
+        d->sink.append('\n');
+    return d->sink.flush() && d->ok;
+}
+
+namespace {
+    const int MaxDepth = 1024; // same nesting limit as QJsonDocument
+
+    // SWAR helpers, eight bytes per step without depending on a particular instruction set
+    const quint64 OnesPerByte = Q_UINT64_C(0x0101010101010101);
+    const quint64 HighBitPerByte = Q_UINT64_C(0x8080808080808080);
+
+    inline bool hasZeroByte(quint64 word)
+    {
+        return ((word - OnesPerByte) & ~word & HighBitPerByte) != 0;
+    }
+
+    inline bool hasByteBelow(quint64 word, unsigned char limit)
+    {
+        return ((word - OnesPerByte * limit) & ~word & HighBitPerByte) != 0;
+    }
+
+    // First byte in [pos, end) that ends a plain string run: '"', '\\' or a control character
+    const char *scanString(const char *pos, const char *end)
+    {
+        while(end - pos >= 8) {
+            quint64 word;
+            std::memcpy(&word, pos, sizeof(word));
+            if(hasZeroByte(word ^ (OnesPerByte * '"')) || hasZeroByte(word ^ (OnesPerByte * '\\')) || hasByteBelow(word, 0x20))
+                break;
+            pos += 8;
+        }
+        while(pos < end) {
+            const unsigned char c = static_cast<unsigned char>(*pos);
+            if(c == '"' || c == '\\' || c < 0x20)
+                return pos;
+            ++pos;
+        }
+        return end;
+    }
+
+    void appendUtf8(std::string &out, uint codePoint)
+    {
+        if(codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if(codePoint < 0x800) {
+            out += static_cast<char>(0xc0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        } else if(codePoint < 0x10000) {
+            out += static_cast<char>(0xe0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        }
+    }
+
+    // Recursive descent parser that builds the variant tree in place: containers are
+    // created first and children are parsed straight into their slots
+    class JsonReader
+    {
+    public:
+        JsonReader(const char *data, int size) :
+            m_begin(data),
+            m_pos(data),
+            m_end(data + size),
+            m_error(nullptr)
+        {
+        }
+
+        bool parse(firebase::Variant &out)
+        {
+            skipWhitespace();
+            if(!value(out, 0))
+                return false;
+            skipWhitespace();
+            if(m_pos != m_end)
+                return fail("garbage at the end of the document");
+            return true;
+        }
+
+        QString errorString() const
+        {
+            return QStringLiteral("%1 at offset %2").arg(QLatin1String(m_error)).arg(m_pos - m_begin);
+        }
+
+    private:
+        bool fail(const char *error)
+        {
+            m_error = error;
+            return false;
+        }
+
+        void skipWhitespace()
+        {
+            while(m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+                ++m_pos;
+        }
+
+        bool value(firebase::Variant &out, int depth)
+        {
+            if(m_pos == m_end)
+                return fail("unexpected end of document");
+
+            switch(*m_pos) {
+            case '{':
+                return object(out, depth + 1);
+            case '[':
+                return array(out, depth + 1);
+            case '"':
+                out = firebase::Variant(std::string());
+                return string(out.mutable_string());
+            case 't':
+                return literal("true", 4, firebase::Variant(true), out);
+            case 'f':
+                return literal("false", 5, firebase::Variant(false), out);
+            case 'n':
+                return literal("null", 4, firebase::Variant::Null(), out);
+            default:
+                return number(out);
+            }
+        }
+
+        bool object(firebase::Variant &out, int depth)
+        {
+            if(depth > MaxDepth)
+                return fail("document too deep");
+
+            out = firebase::Variant::EmptyMap();
+            std::map<firebase::Variant, firebase::Variant> &map = out.map();
+
+            ++m_pos;
+            skipWhitespace();
+            if(m_pos < m_end && *m_pos == '}') {
+                ++m_pos;
+                return true;
+            }
+
+            while(true) {
+                if(m_pos == m_end || *m_pos != '"')
+                    return fail("object key expected");
+
+                firebase::Variant key{std::string()};
+                if(!string(key.mutable_string()))
+                    return false;
+
+                skipWhitespace();
+                if(m_pos == m_end || *m_pos != ':')
+                    return fail("':' expected");
+                ++m_pos;
+                skipWhitespace();
+
+                // Duplicate keys: the last one wins, like QJsonObject
+                if(!value(map[std::move(key)], depth))
+                    return false;
+
+                skipWhitespace();
+                if(m_pos == m_end)
+                    return fail("unterminated object");
+                if(*m_pos == '}') {
+                    ++m_pos;
+                    return true;
+                }
+                if(*m_pos != ',')
+                    return fail("',' or '}' expected");
+                ++m_pos;
+                skipWhitespace();
+            }
+        }
+
+        bool array(firebase::Variant &out, int depth)
+        {
+            if(depth > MaxDepth)
+                return fail("document too deep");
+
+            out = firebase::Variant::EmptyVector();
+            std::vector<firebase::Variant> &vector = out.vector();
+
+            ++m_pos;
+            skipWhitespace();
+            if(m_pos < m_end && *m_pos == ']') {
+                ++m_pos;
+                return true;
+            }
+
+            while(true) {
+                vector.emplace_back();
+                if(!value(vector.back(), depth))
+                    return false;
+
+                skipWhitespace();
+                if(m_pos == m_end)
+                    return fail("unterminated array");
+                if(*m_pos == ']') {
+                    ++m_pos;
+                    return true;
+                }
+                if(*m_pos != ',')
+                    return fail("',' or ']' expected");
+                ++m_pos;
+                skipWhitespace();
+            }
+        }
+
+        bool literal(const char *text, int size, const firebase::Variant &value, firebase::Variant &out)
+        {
+            if(m_end - m_pos < size || std::memcmp(m_pos, text, size) != 0)
+                return fail("illegal value");
+            m_pos += size;
+            out = value;
+            return true;
+        }
+
+        static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+        bool number(firebase::Variant &out)
+        {
+            const char *start = m_pos;
+            const bool negative = *m_pos == '-';
+            if(negative)
+                ++m_pos;
+
+            // Integer part: a single 0 or a digit sequence without leading zeros
+            const char *digits = m_pos;
+            if(m_pos < m_end && *m_pos == '0') {
+                ++m_pos;
+            } else {
+                while(m_pos < m_end && isDigit(*m_pos))
+                    ++m_pos;
+            }
+            if(m_pos == digits)
+                return fail("illegal value");
+
+            bool integral = true;
+            if(m_pos < m_end && *m_pos == '.') {
+                integral = false;
+                const char *fraction = ++m_pos;
+                while(m_pos < m_end && isDigit(*m_pos))
+                    ++m_pos;
+                if(m_pos == fraction)
+                    return fail("illegal number");
+            }
+            if(m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+                integral = false;
+                ++m_pos;
+                if(m_pos < m_end && (*m_pos == '+' || *m_pos == '-'))
+                    ++m_pos;
+                const char *exponent = m_pos;
+                while(m_pos < m_end && isDigit(*m_pos))
+                    ++m_pos;
+                if(m_pos == exponent)
+                    return fail("illegal number");
+            }
+
+            // Integers are accumulated exactly and kept as int64, only the ones outside of its range become doubles
+            if(integral) {
+                const quint64 limit = negative ? Q_UINT64_C(9223372036854775808) : Q_UINT64_C(9223372036854775807);
+                quint64 value = 0;
+                const char *p = digits;
+                for(; p < m_pos; ++p) {
+                    const quint64 digit = static_cast<quint64>(*p - '0');
+                    if(value > (limit - digit) / 10)
+                        break;
+                    value = value * 10 + digit;
+                }
+                if(p == m_pos) {
+                    // NOTE negated as unsigned, the magnitude of INT64_MIN does not fit in int64
+                    out = firebase::Variant(static_cast<int64_t>(negative ? 0 - value : value));
+                    return true;
+                }
+            }
+
+            bool ok = false;
+            const double value = QByteArray::fromRawData(start, static_cast<int>(m_pos - start)).toDouble(&ok);
+            if(!ok)
+                return fail("illegal number");
+            out = firebase::Variant(value);
+            return true;
+        }
+
+        bool string(std::string &out)
+        {
+            ++m_pos; // opening quote
+            while(true) {
+                const char *run = m_pos;
+                m_pos = scanString(m_pos, m_end);
+                out.append(run, static_cast<size_t>(m_pos - run));
+
+                if(m_pos == m_end)
+                    return fail("unterminated string");
+
+                const char c = *m_pos++;
+                if(c == '"')
+                    return true;
+                if(c != '\\')
+                    return fail("control character in string");
+                if(!escape(out))
+                    return false;
+            }
+        }
+
+        bool escape(std::string &out)
+        {
+            if(m_pos == m_end)
+                return fail("unterminated string");
+
+            switch(*m_pos++) {
+            case '"': out += '"'; return true;
+            case '\\': out += '\\'; return true;
+            case '/': out += '/'; return true;
+            case 'b': out += '\b'; return true;
+            case 'f': out += '\f'; return true;
+            case 'n': out += '\n'; return true;
+            case 'r': out += '\r'; return true;
+            case 't': out += '\t'; return true;
+            case 'u': break;
+            default: return fail("illegal escape sequence");
+            }
+
+            uint codePoint;
+            if(!hex4(codePoint))
+                return false;
+            if(codePoint >= 0xd800 && codePoint < 0xdc00) {
+                // High surrogate, must be followed by an escaped low surrogate
+                uint low;
+                if(m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u')
+                    return fail("illegal UTF-16 sequence");
+                m_pos += 2;
+                if(!hex4(low))
+                    return false;
+                if(low < 0xdc00 || low >= 0xe000)
+                    return fail("illegal UTF-16 sequence");
+                codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+            } else if(codePoint >= 0xdc00 && codePoint < 0xe000) {
+                return fail("illegal UTF-16 sequence");
+            }
+            appendUtf8(out, codePoint);
+            return true;
+        }
+
+        bool hex4(uint &value)
+        {
+            if(m_end - m_pos < 4)
+                return fail("illegal escape sequence");
+
+            value = 0;
+            for(int i = 0; i < 4; ++i) {
+                const char c = *m_pos++;
+                value <<= 4;
+                if(c >= '0' && c <= '9')
+                    value |= static_cast<uint>(c - '0');
+                else if(c >= 'a' && c <= 'f')
+                    value |= static_cast<uint>(c - 'a' + 10);
+                else if(c >= 'A' && c <= 'F')
+                    value |= static_cast<uint>(c - 'A' + 10);
+                else
+                    return fail("illegal escape sequence");
+            }
+            return true;
+        }
+
+        const char *m_begin;
+        const char *m_pos;
+        const char *m_end;
+        const char *m_error;
+    };
+}
+
+QByteArray QtFirebaseJson::toJson(const firebase::Variant &variant, Format format)
+{
+    QByteArray json;
+    json.reserve(estimateSize(variant, 0, format == Compact) + 1);
+
+    ByteArraySink sink(json);
+    writeDocument(sink, variant, format);
+    return json;
+}
+
+bool QtFirebaseJson::write(const firebase::Variant &variant, QIODevice *device, Format format)
+{
+    if(!device || !device->isWritable()) {
+        qCWarning(lcQtFirebase) << "QtFirebaseJson::write" << "device is not writable";
+        return false;
+    }
+
+    DeviceSink sink(device);
+    writeDocument(sink, variant, format);
+    return sink.flush();
+}
+
+bool QtFirebaseJson::fromJson(const char *data, int size, firebase::Variant &variant, QString *errorString)
+{
+    JsonReader reader(data, size);
+    if(reader.parse(variant))
+        return true;
+
+    variant = firebase::Variant::Null();
+    if(errorString)
+        *errorString = reader.errorString();
+    return false;
+}
+
+bool QtFirebaseJson::fromJson(const QByteArray &json, firebase::Variant &variant, QString *errorString)
+{
+    return fromJson(json.constData(), json.size(), variant, errorString);
+}
+
+bool QtFirebaseJson::read(QIODevice *device, firebase::Variant &variant, QString *errorString)
+{
+    if(!device || !device->isReadable()) {
+        variant = firebase::Variant::Null();
+        if(errorString)
+            *errorString = QStringLiteral("device is not readable");
+        return false;
+    }
+
+    // Files are parsed from a memory mapping, without copying them into a buffer first
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if(file && !file->isSequential()) {
+        const qint64 offset = file->pos();
+        const qint64 size = file->size() - offset;
+        if(size > 0 && size <= std::numeric_limits<int>::max()) {
+            if(uchar *mapped = file->map(offset, size)) {
+                const bool ok = fromJson(reinterpret_cast<const char *>(mapped), static_cast<int>(size), variant, errorString);
+                file->unmap(mapped);
+                if(ok)
+                    file->seek(offset + size);
+                return ok;
+            }
+        }
+    }
+
+    return fromJson(device->readAll(), variant, errorString);
+}
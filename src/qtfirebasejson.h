@@ -0,0 +1,83 @@
+#ifndef QTFIREBASE_JSON_H
+#define QTFIREBASE_JSON_H
+
+#include "firebase/variant.h"
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+class QIODevice;
+
+/*
+ * JSON serialization of firebase::Variant trees
+ *
+ * Writes UTF-8 straight from the variant tree, without building QVariant or
+ * QJsonDocument trees first. The output matches QJsonDocument::toJson() for the
+ * same data (4 space indentation, integral numbers without exponent).
+ * Scalars at the top level are written as they are.
+ *
+ * Parsing goes the other way, from UTF-8 into firebase::Variant, again without
+ * intermediate trees. Integers that fit are read as int64, other numbers as double.
+ */
+class QtFirebaseJson
+{
+public:
+    enum Format
+    {
+        Indented,
+        Compact
+    };
+
+    // The array is sized up front from a quick pass over the tree
+    static QByteArray toJson(const firebase::Variant &variant, Format format = Indented);
+    // Streams through a small buffer, returns false if the device reported a write error
+    static bool write(const firebase::Variant &variant, QIODevice *device, Format format = Indented);
+
+    // On failure 'variant' is null and 'errorString' (when given) says what went wrong and where
+    static bool fromJson(const char *data, int size, firebase::Variant &variant, QString *errorString = nullptr);
+    static bool fromJson(const QByteArray &json, firebase::Variant &variant, QString *errorString = nullptr);
+    // Reads from the current position to the end, files are memory mapped when possible
+    static bool read(QIODevice *device, firebase::Variant &variant, QString *errorString = nullptr);
+};
+
+/*
+ * Incremental JSON writer for trees that are not firebase::Variants (e.g. snapshot nodes)
+ *
+ * Produces the same output as QtFirebaseJson::toJson() / write() for the same data.
+ * Object entries are a key() followed by a value() or a nested object or array.
+ *
+ * Usage:
+ *   QtFirebaseJsonWriter writer(&json);
+ *   writer.beginObject();
+ *   writer.key("name", 4);
+ *   writer.value(firebase::Variant::FromStaticString("Ada"));
+ *   writer.endObject();
+ *   writer.finish();
+ */
+class QtFirebaseJsonWriter
+{
+public:
+    explicit QtFirebaseJsonWriter(QByteArray *out, QtFirebaseJson::Format format = QtFirebaseJson::Indented);
+    // Streams through a small buffer like QtFirebaseJson::write()
+    explicit QtFirebaseJsonWriter(QIODevice *device, QtFirebaseJson::Format format = QtFirebaseJson::Indented);
+    ~QtFirebaseJsonWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(const char *data, int size);
+    // Scalars, or whole variant subtrees
+    void value(const firebase::Variant &value);
+    // Ends the document and flushes, false if the device reported a write error
+    bool finish();
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+
+    Q_DISABLE_COPY(QtFirebaseJsonWriter)
+};
+
+#endif // QTFIREBASE_JSON_H
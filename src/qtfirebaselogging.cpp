@@ -0,0 +1,12 @@
+#include "qtfirebaselogging.h"
+
+// Debug output is opt-in, warnings and up are shown by default
+Q_LOGGING_CATEGORY(lcQtFirebase, "qtfirebase", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseService, "qtfirebase.service", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseAdMob, "qtfirebase.admob", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseAnalytics, "qtfirebase.analytics", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseAuth, "qtfirebase.auth", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseDatabase, "qtfirebase.database", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseMessaging, "qtfirebase.messaging", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseRemoteConfig, "qtfirebase.remoteconfig", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcQtFirebaseStorage, "qtfirebase.storage", QtInfoMsg)
@@ -0,0 +1,33 @@
+#ifndef QTFIREBASE_LOGGING_H
+#define QTFIREBASE_LOGGING_H
+
+#include <QLoggingCategory>
+
+/*
+ * Logging categories of the QtFirebase modules
+ *
+ * Debug output is off by default and can be enabled per module at runtime, e.g.
+ *   QT_LOGGING_RULES="qtfirebase.database.debug=true"
+ * Arguments are only evaluated when the category is enabled.
+ *
+ * Building with QTFIREBASE_CONFIG += nodebuglog (QTFIREBASE_NO_DEBUG_LOG) compiles
+ * all qtfbDebug() statements out. Warnings are always kept.
+ */
+
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebase)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseService)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseAdMob)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseAnalytics)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseAuth)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseDatabase)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseMessaging)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseRemoteConfig)
+Q_DECLARE_LOGGING_CATEGORY(lcQtFirebaseStorage)
+
+#if defined(QTFIREBASE_NO_DEBUG_LOG)
+#define qtfbDebug(category) while (false) QMessageLogger().noDebug()
+#else
+#define qtfbDebug(category) qCDebug(category)
+#endif
+
+#endif // QTFIREBASE_LOGGING_H
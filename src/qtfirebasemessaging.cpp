@@ -17,25 +17,20 @@ QtFirebaseMessaging::QtFirebaseMessaging(QObject* parent)
     : QObject(parent)
     , g_listener(new MessageListener())
 {
-    __QTFIREBASE_ID = QString().sprintf("%8p", this);
-
     if(!self) {
         self = this;
-        qDebug() << self << "::QtFirebaseMessaging" << "singleton";
+        qtfbDebug(lcQtFirebaseMessaging) << self << "::QtFirebaseMessaging" << "singleton";
     }
 
     _ready = false;
     _initializing = false;
 
-    if(qFirebase->ready()) {
-        //Call init outside of constructor, otherwise signal readyChanged not emited
-        QTimer::singleShot(100, this, &QtFirebaseMessaging::init);
-    } else {
-        connect(qFirebase,&QtFirebase::readyChanged, this, &QtFirebaseMessaging::init);
+    // Initialize registers the listener with the platform, keep it on the GUI thread.
+    // The scheduler calls init outside of constructor, otherwise signal readyChanged not emited
+    qFirebase->initScheduler()->addModule(QStringLiteral("QtFirebaseMessaging"), QtFirebaseInitScheduler::GuiThread,
+                                          QtFirebaseInitScheduler::Work(), this, [this]() { init(); });
+    if(!qFirebase->ready())
         qFirebase->requestInit();
-    }
-
-    connect(qFirebase,&QtFirebase::futureEvent, this, &QtFirebaseMessaging::onFutureEvent);
 }
 
 QtFirebaseMessaging::~QtFirebaseMessaging()
@@ -60,14 +55,14 @@ bool QtFirebaseMessaging::checkInstance(const char *function)
 {
     const bool b = (QtFirebaseMessaging::self != nullptr);
     if (!b)
-        qWarning("QtFirebaseMessaging::%s: Please instantiate the QtFirebaseMessaging object first", function);
+        qCWarning(lcQtFirebaseMessaging, "QtFirebaseMessaging::%s: Please instantiate the QtFirebaseMessaging object first", function);
     return b;
 }
 
 void QtFirebaseMessaging::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << self << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseMessaging) << self << "::init" << "base not ready";
         return;
     }
 
@@ -79,23 +74,6 @@ void QtFirebaseMessaging::init()
     }
 }
 
-void QtFirebaseMessaging::onFutureEvent(const QString &eventId, const firebase::FutureBase &future)
-{
-    if(!eventId.startsWith(__QTFIREBASE_ID))
-        return;
-
-    qDebug() << self << "::onFutureEvent" << eventId;;
-
-    if(future.status() != firebase::kFutureStatusComplete)
-    {
-        qDebug() << this << "::onFutureEvent initializing failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
-        _initializing = false;
-        return;
-    }
-    qDebug() << this << "::onFutureEvent initialized ok";
-    _initializing = false;
-}
-
 void QtFirebaseMessaging::getMessage()
 {
     setData(g_listener->data());
@@ -115,6 +93,8 @@ void QtFirebaseMessaging::setReady(bool ready)
 {
     if (_ready != ready) {
         _ready = ready;
+        if(_ready)
+            qFirebase->recordStartup(QStringLiteral("QtFirebaseMessaging"));
         emit readyChanged();
     }
 }
@@ -42,7 +42,7 @@ public:
     static QtFirebaseMessaging *instance() {
         if(!self) {
             self = new QtFirebaseMessaging();
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseMessaging) << self << "::instance" << "singleton";
         }
         return self;
     }
@@ -60,7 +60,6 @@ public:
 
 private slots:
     void init();
-    void onFutureEvent(const QString &eventId, const firebase::FutureBase &future);
     void getMessage();
     void getToken();
 
@@ -77,7 +76,6 @@ private:
     bool _ready;
     bool _initializing;
 
-    QString __QTFIREBASE_ID;
     MessageListener* g_listener = nullptr;
     QVariantMap _data;
     QString _token;
@@ -0,0 +1,302 @@
+#include "qtfirebasemetrics.h"
+#include "qtfirebaselogging.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+namespace {
+    struct OperationName
+    {
+        const char *module;
+        const char *action;
+    };
+
+    // Indexed by QtFirebaseMetrics::Operation
+    const OperationName operationNames[QtFirebaseMetrics::OperationCount] = {
+        { "database", "get" },
+        { "database", "set" },
+        { "database", "update" },
+        { "database", "remove" },
+        { "storage", "save" },
+        { "storage", "getUrl" },
+        { "storage", "delete" },
+        { "auth", "signin" },
+        { "auth", "register" },
+        { "auth", "deleteUser" },
+        { "auth", "passwordReset" },
+        { "auth", "emailVerification" },
+        { "remoteConfig", "fetch" }
+    };
+
+    qint64 monotonicNanos()
+    {
+        static const QElapsedTimer clock = []() {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+        return clock.nsecsElapsed();
+    }
+}
+
+QtFirebaseMetrics::Counters QtFirebaseMetrics::s_counters[QtFirebaseMetrics::OperationCount];
+QAtomicInteger<quint64> QtFirebaseMetrics::s_routed;
+QAtomicInteger<quint64> QtFirebaseMetrics::s_savedDispatches;
+
+QtFirebaseMetrics::QtFirebaseMetrics(QObject *parent) : QObject(parent)
+{
+    writeOnQuit();
+}
+
+QtFirebaseMetrics *QtFirebaseMetrics::instance()
+{
+    static QtFirebaseMetrics *self = new QtFirebaseMetrics();
+    return self;
+}
+
+qint64 QtFirebaseMetrics::begin(Operation operation)
+{
+    if(operation < 0 || operation >= OperationCount)
+        return 0;
+
+    Counters &counters = s_counters[operation];
+    counters.issued.fetchAndAddRelaxed(1);
+    counters.inFlight.fetchAndAddRelaxed(1);
+    return monotonicNanos();
+}
+
+void QtFirebaseMetrics::end(Operation operation, qint64 started, int error)
+{
+    if(operation < 0 || operation >= OperationCount)
+        return;
+
+    const quint64 micros = static_cast<quint64>(qMax(Q_INT64_C(0), monotonicNanos() - started)) / 1000;
+
+    Counters &counters = s_counters[operation];
+    counters.inFlight.fetchAndSubRelaxed(1);
+    counters.completed.fetchAndAddRelaxed(1);
+    counters.totalMicros.fetchAndAddRelaxed(micros);
+    counters.latency[bucketOf(micros)].fetchAndAddRelaxed(1);
+
+    quint64 max = counters.maxMicros.load();
+    while(micros > max && !counters.maxMicros.testAndSetRelaxed(max, micros, max)) {}
+
+    if(error != 0) {
+        const int index = (error >= ErrorMin && error < ErrorMin + ErrorBuckets - 1) ? error - ErrorMin : ErrorBuckets - 1;
+        counters.errors[index].fetchAndAddRelaxed(1);
+    }
+}
+
+int QtFirebaseMetrics::errorOf(const firebase::FutureBase &future)
+{
+    switch(future.status()) {
+    case firebase::kFutureStatusComplete:
+        return future.error();
+    case firebase::kFutureStatusPending:
+        return ErrorTimeout;
+    default:
+        return ErrorInvalid;
+    }
+}
+
+void QtFirebaseMetrics::routed(int receivers)
+{
+    s_routed.fetchAndAddRelaxed(1);
+    if(receivers > 1)
+        s_savedDispatches.fetchAndAddRelaxed(static_cast<quint64>(receivers - 1));
+}
+
+int QtFirebaseMetrics::bucketOf(quint64 micros)
+{
+    if(micros < SubBuckets)
+        return static_cast<int>(micros);
+
+    // Position of the highest set bit picks the power of two, the next SubBucketBits bits the linear sub-bucket
+    const int exponent = 63 - static_cast<int>(qCountLeadingZeroBits(micros));
+    if(exponent > MaxExponent)
+        return BucketCount - 1;
+
+    const int subBucket = static_cast<int>((micros >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    return (exponent - SubBucketBits + 1) * SubBuckets + subBucket;
+}
+
+quint64 QtFirebaseMetrics::bucketValue(int bucket)
+{
+    // Lowest value that lands in the bucket
+    if(bucket < SubBuckets)
+        return static_cast<quint64>(bucket);
+
+    const int exponent = bucket / SubBuckets + SubBucketBits - 1;
+    const quint64 subBucket = static_cast<quint64>(bucket % SubBuckets);
+    return (SubBuckets + subBucket) << (exponent - SubBucketBits);
+}
+
+QVariantMap QtFirebaseMetrics::snapshot() const
+{
+    QVariantMap result;
+    for(int i = 0; i < OperationCount; ++i)
+        result.insert(QString::fromLatin1(QMetaEnum::fromType<Operation>().valueToKey(i)), operation(i));
+    return result;
+}
+
+QVariantMap QtFirebaseMetrics::operation(const QString &name) const
+{
+    const int index = indexOf(name);
+    return index < 0 ? QVariantMap() : operation(index);
+}
+
+QStringList QtFirebaseMetrics::operations() const
+{
+    QStringList names;
+    for(int i = 0; i < OperationCount; ++i)
+        names << QString::fromLatin1(QMetaEnum::fromType<Operation>().valueToKey(i));
+    return names;
+}
+
+double QtFirebaseMetrics::percentile(const QString &name, double percentile) const
+{
+    const int index = indexOf(name);
+    return index < 0 ? 0.0 : this->percentile(index, percentile);
+}
+
+QVariantMap QtFirebaseMetrics::dispatch() const
+{
+    QVariantMap result;
+    result.insert(QStringLiteral("routed"), s_routed.load());
+    result.insert(QStringLiteral("saved"), s_savedDispatches.load());
+    return result;
+}
+
+void QtFirebaseMetrics::reset()
+{
+    s_routed.store(0);
+    s_savedDispatches.store(0);
+
+    // In flight operations are still in flight, everything else starts over
+    for(Counters &counters : s_counters) {
+        counters.issued.store(static_cast<quint64>(qMax(Q_INT64_C(0), counters.inFlight.load())));
+        counters.completed.store(0);
+        counters.totalMicros.store(0);
+        counters.maxMicros.store(0);
+        for(QAtomicInteger<quint64> &count : counters.errors)
+            count.store(0);
+        for(QAtomicInteger<quint64> &count : counters.latency)
+            count.store(0);
+    }
+}
+
+QString QtFirebaseMetrics::toJson() const
+{
+    QJsonObject operations;
+    for(int i = 0; i < OperationCount; ++i) {
+        QJsonObject entry = QJsonObject::fromVariantMap(operation(i));
+
+        QJsonArray histogram;
+        for(int bucket = 0; bucket < BucketCount; ++bucket) {
+            const quint64 count = s_counters[i].latency[bucket].load();
+            if(count > 0)
+                histogram.append(QJsonArray { static_cast<double>(bucketValue(bucket)), static_cast<double>(count) });
+        }
+        entry.insert(QStringLiteral("histogram"), histogram);
+
+        operations.insert(QString::fromLatin1(QMetaEnum::fromType<Operation>().valueToKey(i)), entry);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("format"), 1);
+    root.insert(QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    root.insert(QStringLiteral("operations"), operations);
+    root.insert(QStringLiteral("dispatch"), QJsonObject::fromVariantMap(dispatch()));
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+bool QtFirebaseMetrics::writeJson(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly) || file.write(toJson().toUtf8()) < 0 || !file.commit()) {
+        qCWarning(lcQtFirebase) << "QtFirebaseMetrics::writeJson" << fileName << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void QtFirebaseMetrics::writeOnQuit()
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("QTFIREBASE_METRICS_FILE"));
+    if(fileName.isEmpty() || !QCoreApplication::instance())
+        return;
+
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this, fileName]() {
+        writeJson(fileName);
+    });
+}
+
+int QtFirebaseMetrics::indexOf(const QString &name) const
+{
+    bool ok = false;
+    const int index = QMetaEnum::fromType<Operation>().keyToValue(name.toLatin1().constData(), &ok);
+    return ok && index >= 0 && index < OperationCount ? index : -1;
+}
+
+QVariantMap QtFirebaseMetrics::operation(int index) const
+{
+    const Counters &counters = s_counters[index];
+    const quint64 completed = counters.completed.load();
+
+    QVariantMap errors;
+    for(int i = 0; i < ErrorBuckets; ++i) {
+        const quint64 count = counters.errors[i].load();
+        if(count > 0)
+            errors.insert(i == ErrorBuckets - 1 ? QStringLiteral("other") : QString::number(i + ErrorMin), count);
+    }
+
+    QVariantMap result;
+    result.insert(QStringLiteral("module"), QString::fromLatin1(operationNames[index].module));
+    result.insert(QStringLiteral("action"), QString::fromLatin1(operationNames[index].action));
+    result.insert(QStringLiteral("issued"), counters.issued.load());
+    result.insert(QStringLiteral("inFlight"), counters.inFlight.load());
+    result.insert(QStringLiteral("completed"), completed);
+    result.insert(QStringLiteral("errors"), errors);
+    result.insert(QStringLiteral("mean"), completed > 0 ? counters.totalMicros.load() / 1000.0 / completed : 0.0);
+    result.insert(QStringLiteral("max"), counters.maxMicros.load() / 1000.0);
+    result.insert(QStringLiteral("p50"), percentile(index, 50.0));
+    result.insert(QStringLiteral("p90"), percentile(index, 90.0));
+    result.insert(QStringLiteral("p99"), percentile(index, 99.0));
+    return result;
+}
+
+double QtFirebaseMetrics::percentile(int index, double percentile) const
+{
+    const Counters &counters = s_counters[index];
+
+    quint64 counts[BucketCount];
+    quint64 total = 0;
+    for(int i = 0; i < BucketCount; ++i) {
+        counts[i] = counters.latency[i].load();
+        total += counts[i];
+    }
+    if(total == 0)
+        return 0.0;
+
+    const quint64 rank = qMax(Q_UINT64_C(1), static_cast<quint64>(qBound(0.0, percentile, 100.0) / 100.0 * total + 0.5));
+    quint64 seen = 0;
+    for(int i = 0; i < BucketCount; ++i) {
+        seen += counts[i];
+        if(seen >= rank) {
+            // Report the middle of the bucket, never beyond the largest recorded value
+            const quint64 low = bucketValue(i);
+            const quint64 high = i + 1 < BucketCount ? bucketValue(i + 1) : low;
+            const quint64 value = qMin(low + (high - low) / 2, counters.maxMicros.load());
+            return value / 1000.0;
+        }
+    }
+    return counters.maxMicros.load() / 1000.0;
+}
@@ -0,0 +1,130 @@
+#ifndef QTFIREBASE_METRICS_H
+#define QTFIREBASE_METRICS_H
+
+#include "firebase/future.h"
+
+#include <QAtomicInteger>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#if defined(qFirebaseMetrics)
+#undef qFirebaseMetrics
+#endif
+#define qFirebaseMetrics (static_cast<QtFirebaseMetrics *>(QtFirebaseMetrics::instance()))
+
+/*
+ * Latency and throughput of Firebase operations
+ *
+ * Recording is lock free and allocation free: begin() reads the monotonic clock
+ * and bumps two atomics, end() bumps a few more. Names, maps and percentiles
+ * are only built when a snapshot is requested (from C++ or QML as "Metrics").
+ *
+ * Latencies go into log-linear (HDR style) histograms: 16 linear sub-buckets
+ * per power of two microseconds, so every bucket is within 6.25% of its value.
+ *
+ * Usage:
+ *   const qint64 started = QtFirebaseMetrics::begin(QtFirebaseMetrics::DatabaseGet);
+ *   ...
+ *   QtFirebaseMetrics::end(QtFirebaseMetrics::DatabaseGet, started, QtFirebaseMetrics::errorOf(future));
+ */
+class QtFirebaseMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Operation
+    {
+        DatabaseGet,
+        DatabaseSet,
+        DatabaseUpdate,
+        DatabaseRemove,
+        StorageSave,
+        StorageGetUrl,
+        StorageDelete,
+        AuthSignIn,
+        AuthRegister,
+        AuthDeleteUser,
+        AuthPasswordReset,
+        AuthEmailVerification,
+        RemoteConfigFetch,
+        OperationCount,
+        None = -1
+    };
+    Q_ENUM(Operation)
+
+    // Error codes recorded for futures that did not complete
+    enum FutureError
+    {
+        ErrorTimeout = -1, // still pending, matches the ErrorTimeout of the modules
+        ErrorInvalid = -2,
+        ErrorCancelled = -3 // removed before it completed, e.g. the request object was destroyed
+    };
+
+    static QtFirebaseMetrics *instance();
+
+    static qint64 begin(Operation operation);
+    static void end(Operation operation, qint64 started, int error);
+    static int errorOf(const firebase::FutureBase &future);
+    // A completion delivered straight to the object that registered it. receivers is the number
+    // of objects with futures registered at that moment, a futureEvent broadcast invokes them all
+    static void routed(int receivers);
+
+    // Per operation: module, action, issued, inFlight, completed, errors (code -> count),
+    // and latency in ms: mean, max, p50, p90, p99
+    Q_INVOKABLE QVariantMap snapshot() const;
+    Q_INVOKABLE QVariantMap operation(const QString &name) const;
+    Q_INVOKABLE QStringList operations() const;
+    // Latency (ms) below which 'percentile' percent of the completed operations finished
+    Q_INVOKABLE double percentile(const QString &name, double percentile) const;
+    // Future dispatch: routed (completions delivered to their receiver only) and
+    // saved (slot invocations a futureEvent broadcast would have cost on top of those)
+    Q_INVOKABLE QVariantMap dispatch() const;
+    Q_INVOKABLE void reset();
+
+    // Machine readable export for tracking regressions across builds and SDK upgrades:
+    // { "format": 1, "timestamp", "qt", "operations": { name: snapshot fields plus
+    // "histogram": [[lowest microseconds of the bucket, count], ...] }, "dispatch": dispatch() }
+    // Set QTFIREBASE_METRICS_FILE to have it written when the application quits
+    Q_INVOKABLE QString toJson() const;
+    bool writeJson(const QString &fileName) const;
+
+    enum {
+        SubBucketBits = 4,
+        SubBuckets = 1 << SubBucketBits,
+        MaxExponent = 36, // ~19 hours in microseconds, longer latencies land in the last bucket
+        BucketCount = (MaxExponent - SubBucketBits + 2) * SubBuckets,
+        ErrorMin = ErrorCancelled,
+        ErrorBuckets = 64 // ErrorMin .. ErrorMin + 62, plus one for everything else
+    };
+
+    static int bucketOf(quint64 micros);
+    static quint64 bucketValue(int bucket);
+
+private:
+    explicit QtFirebaseMetrics(QObject *parent = nullptr);
+
+    struct Counters
+    {
+        QAtomicInteger<quint64> issued;
+        QAtomicInteger<quint64> completed;
+        QAtomicInteger<qint64> inFlight;
+        QAtomicInteger<quint64> totalMicros;
+        QAtomicInteger<quint64> maxMicros;
+        QAtomicInteger<quint64> errors[ErrorBuckets];
+        QAtomicInteger<quint64> latency[BucketCount];
+    };
+
+    static Counters s_counters[OperationCount];
+    static QAtomicInteger<quint64> s_routed;
+    static QAtomicInteger<quint64> s_savedDispatches;
+
+    int indexOf(const QString &name) const;
+    QVariantMap operation(int index) const;
+    double percentile(int index, double percentile) const;
+    void writeOnQuit();
+
+    Q_DISABLE_COPY(QtFirebaseMetrics)
+};
+
+#endif // QTFIREBASE_METRICS_H
@@ -1,4 +1,5 @@
 #include "qtfirebaseremoteconfig.h"
+#include "qtfirebasearena.h"
 
 namespace remote_config = ::firebase::remote_config;
 
@@ -11,28 +12,22 @@ QtFirebaseRemoteConfig::QtFirebaseRemoteConfig(QObject *parent) :
     _cacheExpirationTime(firebase::remote_config::kDefaultCacheExpiration*1000), // milliseconds
     __appId(nullptr)
 {
-    __QTFIREBASE_ID = QString().sprintf("%8p", static_cast<void*> (this));
-
     if(self == nullptr)
     {
         self = this;
-        qDebug() << self << "::QtFirebaseRemoteConfig" << "singleton";
+        qtfbDebug(lcQtFirebaseRemoteConfig) << self << "::QtFirebaseRemoteConfig" << "singleton";
     }
 
     #if defined(Q_OS_ANDROID)
     if (GooglePlayServices::available()) {
-        qDebug() << this << " Google Play Services is available, now init remote_config" ;
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << " Google Play Services is available, now init remote_config" ;
 
-        //Call init outside of constructor, otherwise signal readyChanged not emited
-        QTimer::singleShot(500, this, SLOT(delayedInit()));
-        connect(qFirebase,&QtFirebase::futureEvent, this, &QtFirebaseRemoteConfig::onFutureEvent);
+        scheduleInit();
     } else {
-        qDebug() << this << " Google Play Services is NOT available, CANNOT use remote_config" ;
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << " Google Play Services is NOT available, CANNOT use remote_config" ;
     }
     #else
-    //Call init outside of constructor, otherwise signal readyChanged not emited
-    QTimer::singleShot(500, this, SLOT(delayedInit()));
-    connect(qFirebase,&QtFirebase::futureEvent, this, &QtFirebaseRemoteConfig::onFutureEvent);
+    scheduleInit();
     #endif
 }
 
@@ -45,7 +40,7 @@ QtFirebaseRemoteConfig::~QtFirebaseRemoteConfig() {
 bool QtFirebaseRemoteConfig::checkInstance(const char *function)
 {
     bool b = (QtFirebaseRemoteConfig::self != nullptr);
-    if(!b) qWarning("QtFirebaseRemoteConfig::%s:", function);
+    if(!b) qCWarning(lcQtFirebaseRemoteConfig, "QtFirebaseRemoteConfig::%s:", function);
     return b;
 }
 
@@ -54,17 +49,15 @@ void QtFirebaseRemoteConfig::addParameterInternal(const QString &name, const QVa
     _parameters[name] = defaultValue;
 }
 
-void QtFirebaseRemoteConfig::delayedInit()
+void QtFirebaseRemoteConfig::scheduleInit()
 {
-    if(qFirebase->ready())
+    // The ModuleInitializer is asynchronous already, so init runs on the GUI thread.
+    // The scheduler calls init outside of constructor, otherwise signal readyChanged not emited
+    qFirebase->initScheduler()->addModule(QStringLiteral("QtFirebaseRemoteConfig"), QtFirebaseInitScheduler::GuiThread,
+                                          QtFirebaseInitScheduler::Work(), this, [this]() { init(); });
+    if(!qFirebase->ready())
     {
-        qDebug() << this << "::delayedInit : QtFirebase is ready, calling init" ;
-        init();
-    }
-    else
-    {
-        qDebug() << this << "::delayedInit : QtFirebase not ready, connecting to its readyChanged signal" ;
-        connect(qFirebase,&QtFirebase::readyChanged, this, &QtFirebaseRemoteConfig::init);
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::scheduleInit : QtFirebase not ready, requesting init" ;
         qFirebase->requestInit();
     }
 }
@@ -85,9 +78,11 @@ bool QtFirebaseRemoteConfig::ready()
 
 void QtFirebaseRemoteConfig::setReady(bool ready)
 {
-    qDebug() << this << "::setReady before:" << _ready << "now:" << ready;
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::setReady before:" << _ready << "now:" << ready;
     if (_ready != ready) {
         _ready = ready;
+        if(_ready)
+            qFirebase->recordStartup(QStringLiteral("QtFirebaseRemoteConfig"));
         emit readyChanged();
     }
 }
@@ -136,9 +131,9 @@ void QtFirebaseRemoteConfig::addParameter(const QString &name, bool defaultValue
 
 void QtFirebaseRemoteConfig::init()
 {
-    qDebug() << this << "::init" << "called";
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::init" << "called";
     if(!qFirebase->ready()) {
-        qDebug() << this << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::init" << "base not ready";
         return;
     }
 
@@ -148,35 +143,27 @@ void QtFirebaseRemoteConfig::init()
         auto future = _initializer.Initialize(qFirebase->firebaseApp(), nullptr, [](::firebase::App* app, void*) {
             // NOTE only write debug output here when developing
             // Causes crash on re-initialization (probably the "self" reference. And "this" can't be used in a lambda)
-            //qDebug() << self << "::init" << "try to initialize Remote Config";
+            //qtfbDebug(lcQtFirebaseRemoteConfig) << self << "::init" << "try to initialize Remote Config";
             return ::firebase::remote_config::Initialize(*app);
         });
 
-        qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".config.init"), future);
+        qFirebase->addFuture(future, this, [this](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+            Q_UNUSED(handle)
+            firebase::FutureBase result = completed;
+            onFutureEventInit(result);
+        });
     }
 }
 
-void QtFirebaseRemoteConfig::onFutureEvent(QString eventId, firebase::FutureBase future)
-{
-    if(!eventId.startsWith(__QTFIREBASE_ID))
-        return;
-
-    qDebug() << this << "::onFutureEvent" << eventId;
-    if(eventId == __QTFIREBASE_ID + QStringLiteral(".config.fetch"))
-        onFutureEventFetch(future);
-    else if( eventId == __QTFIREBASE_ID + QStringLiteral(".config.init") )
-        onFutureEventInit(future);
-}
-
 void QtFirebaseRemoteConfig::onFutureEventInit(firebase::FutureBase &future)
 {
     if (future.status() != firebase::kFutureStatusComplete) {
-        qDebug() << this << "::onFutureEvent" << "initializing failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::onFutureEvent" << "initializing failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
         _initializing = false;
         return;
     }
 
-    qDebug() << this << "::onFutureEvent initialized ok";
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::onFutureEvent initialized ok";
     _initializing = false;
     setReady(true);
     future.Release();
@@ -186,20 +173,20 @@ void QtFirebaseRemoteConfig::onFutureEventFetch(firebase::FutureBase &future)
 {
     if(future.status() != firebase::kFutureStatusComplete)
     {
-        qDebug() << this << "::onFutureEvent initializing failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::onFutureEvent initializing failed." << "ERROR: Action failed with error code and message: " << future.error() << future.error_message();
         _initializing = false;
         return;
     }
-    qDebug() << this << "::onFutureEvent initialized ok";
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::onFutureEvent initialized ok";
     _initializing = false;
 
     bool fetchActivated = remote_config::ActivateFetched();
     //On first run even if we have activateResult failed we still can get cached values
-    qDebug() << this << QString(QStringLiteral("ActivateFetched %1")).arg(fetchActivated ? QStringLiteral("succeeded") : QStringLiteral("failed"));
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << QString(QStringLiteral("ActivateFetched %1")).arg(fetchActivated ? QStringLiteral("succeeded") : QStringLiteral("failed"));
 
     const remote_config::ConfigInfo& info = remote_config::GetInfo();
 
-    qDebug() << this << QString(QStringLiteral("Info last_fetch_time_ms=%1 fetch_status=%2 failure_reason=%3"))
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << QString(QStringLiteral("Info last_fetch_time_ms=%1 fetch_status=%2 failure_reason=%3"))
                 .arg(QString::number(info.fetch_time))
                 .arg(info.last_fetch_status)
                 .arg(info.last_fetch_failure_reason);
@@ -251,10 +238,10 @@ void QtFirebaseRemoteConfig::onFutureEventFetch(firebase::FutureBase &future)
 
         //SDK code to print out the keys
         /*std::vector<std::string> keys = remote_config::GetKeys();
-        qDebug() << "QtFirebaseRemoteConfig GetKeys:";
+        qtfbDebug(lcQtFirebaseRemoteConfig) << "QtFirebaseRemoteConfig GetKeys:";
         for (auto s = keys.begin(); s != keys.end(); ++s)
         {
-            qDebug() << s->c_str();
+            qtfbDebug(lcQtFirebaseRemoteConfig) << s->c_str();
         }
         keys = remote_config::GetKeysByPrefix("TestD");
         printf("GetKeysByPrefix(\"TestD\"):");
@@ -287,45 +274,74 @@ void QtFirebaseRemoteConfig::fetch()
     fetch(_cacheExpirationTime<1000 ? 0 : _cacheExpirationTime/1000);
 }
 
+static bool isSupportedDefault(const QVariant &value)
+{
+    return value.type() == QVariant::Bool ||
+            value.type() == QVariant::LongLong ||
+            value.type() == QVariant::Int ||
+            value.type() == QVariant::Double ||
+            value.type() == QVariant::String;
+}
+
 void QtFirebaseRemoteConfig::fetch(quint64 cacheExpirationInSeconds)
 {
     if(_parameters.size() == 0)
     {
-        qDebug() << this << "::fetch not started, parameters were not initialized";
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::fetch not started, parameters were not initialized";
         return;
     }
-    qDebug() << this <<"::fetch with expirationtime" << cacheExpirationInSeconds << "seconds";
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this <<"::fetch with expirationtime" << cacheExpirationInSeconds << "seconds";
+
+    applyDefaults();
+
+    /*remote_config::SetConfigSetting(remote_config::kConfigSettingDeveloperMode, "1");
+    if ((*remote_config::GetConfigSetting(remote_config::kConfigSettingDeveloperMode)
+                .c_str()) != '1') {
+        qtfbDebug(lcQtFirebaseRemoteConfig) << "Failed to enable developer mode";
+    }*/
 
-    QVariantMap filteredMap;
+    qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::fetch" << "run fetching...";
+    auto future = remote_config::Fetch(cacheExpirationInSeconds);
+    qFirebase->addFuture(future, this, [this](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+        Q_UNUSED(handle)
+        firebase::FutureBase result = completed;
+        onFutureEventFetch(result);
+    }, 0, QtFirebaseMetrics::RemoteConfigFetch);
+}
+
+void QtFirebaseRemoteConfig::applyDefaults()
+{
+    if(!_ready)
+    {
+        qtfbDebug(lcQtFirebaseRemoteConfig) << this << "::applyDefaults native part not ready";
+        return;
+    }
+
+    size_t count = 0;
     for(QVariantMap::const_iterator it = _parameters.begin(); it!=_parameters.end();++it)
     {
-        const QVariant& value = it.value();
-        if(value.type() == QVariant::Bool ||
-                value.type() == QVariant::LongLong ||
-                value.type() == QVariant::Int ||
-                value.type() == QVariant::Double ||
-                value.type() == QVariant::String)
+        if(isSupportedDefault(it.value()))
         {
-            filteredMap[it.key()] = value;
+            ++count;
         }
         else
         {
-            qWarning() << this << "Data type:" << value.typeName() << " not supported";
+            qCWarning(lcQtFirebaseRemoteConfig) << this << "Data type:" << it.value().typeName() << " not supported";
         }
     }
 
-    // From <memory> include
-    std::unique_ptr<remote_config::ConfigKeyValueVariant[]> defaults(
-                new remote_config::ConfigKeyValueVariant[filteredMap.size()]);
+    // NOTE SetDefaults copies what it needs, keys and strings only live in the arena until it returns
+    QtFirebaseArena arena;
+    remote_config::ConfigKeyValueVariant *defaults = arena.create<remote_config::ConfigKeyValueVariant>(count);
 
-    __defaultsByteArrayList.clear();
     size_t index = 0;
-    for(QVariantMap::const_iterator it = filteredMap.begin(); it!=filteredMap.end();++it)
+    for(QVariantMap::const_iterator it = _parameters.begin(); it!=_parameters.end();++it)
     {
-        __defaultsByteArrayList.insert(static_cast<int> (index),
-                                       QByteArray(it.key().toUtf8().data()));
-        const char* key = __defaultsByteArrayList.at(static_cast<int> (index)).constData();
         const QVariant& value = it.value();
+        if(!isSupportedDefault(value))
+            continue;
+
+        const char* key = arena.utf8(it.key());
 
         if(value.type() == QVariant::Bool)
         {
@@ -346,8 +362,7 @@ void QtFirebaseRemoteConfig::fetch(quint64 cacheExpirationInSeconds)
 
         else if(value.type() == QVariant::String)
         {
-            defaults[index] = remote_config::ConfigKeyValueVariant{key,
-                    value.toString().toUtf8().constData()};
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, arena.utf8(value.toString())};
 
             //Code for data type
             /*QByteArray data = value.toString().toUtf8();
@@ -359,17 +374,7 @@ void QtFirebaseRemoteConfig::fetch(quint64 cacheExpirationInSeconds)
         index++;
     }
 
-    remote_config::SetDefaults(defaults.get(), static_cast<size_t> (filteredMap.size()));
-
-    /*remote_config::SetConfigSetting(remote_config::kConfigSettingDeveloperMode, "1");
-    if ((*remote_config::GetConfigSetting(remote_config::kConfigSettingDeveloperMode)
-                .c_str()) != '1') {
-        qDebug() << "Failed to enable developer mode";
-    }*/
-
-    qDebug() << this << "::fetch" << "run fetching...";
-    auto future = remote_config::Fetch(cacheExpirationInSeconds);
-    qFirebase->addFuture(__QTFIREBASE_ID + QStringLiteral(".config.fetch"), future);
+    remote_config::SetDefaults(defaults, count);
 }
 
 void QtFirebaseRemoteConfig::fetchNow()
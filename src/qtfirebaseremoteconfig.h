@@ -12,7 +12,6 @@
 
 #include "firebase/remote_config.h"
 
-#include <memory> //For std::unique_ptr
 #include <QDebug>
 #include <QObject>
 
@@ -38,7 +37,7 @@ public:
     static QtFirebaseRemoteConfig *instance() {
         if(self == nullptr) {
             self = new QtFirebaseRemoteConfig(nullptr);
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseRemoteConfig) << self << "::instance" << "singleton";
         }
         return self;
     }
@@ -52,6 +51,10 @@ public:
     quint64 cacheExpirationTime() const;
     void setCacheExpirationTime(quint64 timeMs);
 
+    // Hands the parameters of a supported type to the SDK as in-app defaults.
+    // fetch() does this first, call it directly to have them before a fetch
+    void applyDefaults();
+
 public slots:
     void addParameter(const QString &name, long long defaultValue);
     void addParameter(const QString &name, double defaultValue);
@@ -76,21 +79,18 @@ signals:
 
 private slots:
     void addParameterInternal(const QString &name, const QVariant &defaultValue);
-    void delayedInit();
     void init();
-    void onFutureEvent(QString eventId, firebase::FutureBase future);
     void onFutureEventInit(firebase::FutureBase& future);
     void onFutureEventFetch(firebase::FutureBase& future);
 
 private:
+    void scheduleInit();
     void setReady(bool ready);
     void fetch(quint64 cacheExpirationInSeconds);
 
     static QtFirebaseRemoteConfig *self;
     Q_DISABLE_COPY(QtFirebaseRemoteConfig)
 
-    QString __QTFIREBASE_ID;
-
     bool _ready;
     bool _initializing;
     QVariantMap _parameters;
@@ -100,7 +100,6 @@ private:
     QString _appId;
     QByteArray __appIdByteArray;
 
-    QByteArrayList __defaultsByteArrayList;
     const char *__appId;
 };
 
@@ -1,9 +1,12 @@
 #include "qtfirebaseservice.h"
+#include "qtfirebasearena.h"
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <iostream>
+#include <QJSEngine>
 #include <QJSValue>
 #include <QDateTime>
+#include <QVarLengthArray>
 using namespace std;
 
 //For debug purposes
@@ -36,61 +39,61 @@ void printQtVariant(const QVariant& v, const QString& tab)
     switch(v.type())
     {
         case QVariant::Bool:{
-            qDebug() << tab.toUtf8().constData() << v.toBool();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toBool();
             break;
         }
         case QVariant::Int:{
-            qDebug() << tab.toUtf8().constData() << v.toInt();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toInt();
             break;
         }
         case QVariant::UInt:{
-            qDebug() << tab.toUtf8().constData() << v.toUInt();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toUInt();
             break;
         }
         case QVariant::LongLong:{
-            qDebug() << tab.toUtf8().constData() << v.toLongLong();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toLongLong();
             break;
         }
         case QVariant::ULongLong:{
-            qDebug() << tab.toUtf8().constData() << v.toULongLong();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toULongLong();
             break;
         }
         case QVariant::Double:{
-            qDebug() << tab.toUtf8().constData() << v.toDouble();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toDouble();
             break;
         }
         case QVariant::String:{
-            qDebug() << tab.toUtf8().constData() << v.toString().toUtf8().constData();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.toString().toUtf8().constData();
             break;
         }
         case QVariant::ByteArray:{
-            qDebug() << v.toByteArray().constData();
+            qtfbDebug(lcQtFirebaseService) << v.toByteArray().constData();
             break;
         }
         case QVariant::Map:{
             QVariantMap map = v.toMap();
-            qDebug() << tab.toUtf8().constData() << "{";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "{";
             for(QVariantMap::const_iterator it = map.begin();it!=map.end();++it)
             {
-                qDebug() << tab.toUtf8().constData() << it.key().toUtf8().constData() << ":";
+                qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << it.key().toUtf8().constData() << ":";
                 printQtVariant(it.value(), tab+tabKey);
             }
-            qDebug() << tab.toUtf8().constData() << "}";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "}";
             break;
         }
         case QVariant::List:{
             QVariantList lst = v.toList();
-            qDebug() << tab.toUtf8().constData() << "[";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "[";
             for(QVariantList::const_iterator it = lst.begin();it!=lst.end();++it)
             {
                 printQtVariant(*it, tab+tabKey);
             }
-            qDebug() << tab.toUtf8().constData() << "]";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "]";
             break;
 
         }
         default:{
-            qDebug() << "printQtVariant(): Type:" << v.typeName() << "not supported";
+            qtfbDebug(lcQtFirebaseService) << "printQtVariant(): Type:" << v.typeName() << "not supported";
             break;
         }
     }
@@ -104,61 +107,61 @@ void printFbVariant(const firebase::Variant& v, const QString& tab)
     switch(v.type())
     {
         case firebase::Variant::kTypeBool:{
-            qDebug() << tab.toUtf8().constData() << v.bool_value();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.bool_value();
             break;
         }
         case firebase::Variant::kTypeInt64:{
-            qDebug() << tab.toUtf8().constData() << v.int64_value();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.int64_value();
             break;
         }
 
         case firebase::Variant::kTypeDouble:{
-            qDebug() << tab.toUtf8().constData() << v.double_value();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.double_value();
             break;
         }
         case firebase::Variant::kTypeStaticString:{
-            qDebug() << tab.toUtf8().constData() << v.string_value();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.string_value();
             break;
         }
         case firebase::Variant::kTypeMutableString:{
-            qDebug() << tab.toUtf8().constData() << v.mutable_string().c_str();
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << v.mutable_string().c_str();
             break;
         }
         case firebase::Variant::kTypeMap:{
             const std::map<firebase::Variant, firebase::Variant>& map = v.map();
-            qDebug() << tab.toUtf8().constData() << "{";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "{";
             for(std::map<firebase::Variant, firebase::Variant>::const_iterator it = map.begin();it!=map.end();++it)
             {
                 firebase::Variant key = it->first;
                 if(key.type() == firebase::Variant::kTypeMutableString ||
                         key.type() == firebase::Variant::kTypeStaticString)
                 {
-                    qDebug() << tab.toUtf8().constData() << it->first.string_value() << ":";
+                    qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << it->first.string_value() << ":";
                     printFbVariant(it->second, tab+tabKey);
                 }
                 else
                 {
-                    qDebug() << "Input key:" << key.TypeName(v.type());
-                    qDebug() << "QtFirebase does not support non string keys";
+                    qtfbDebug(lcQtFirebaseService) << "Input key:" << key.TypeName(v.type());
+                    qtfbDebug(lcQtFirebaseService) << "QtFirebase does not support non string keys";
                     return;
                 }
             }
-            qDebug() << tab.toUtf8().constData() << "}";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "}";
             break;
         }
         case firebase::Variant::kTypeVector:{
             std::vector<firebase::Variant> lst = v.vector();
-            qDebug() << tab.toUtf8().constData() << "[";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "[";
             for(std::vector<firebase::Variant>::const_iterator it = lst.begin();it!=lst.end();++it)
             {
                 printFbVariant(*it, tab+tabKey);
             }
-            qDebug() << tab.toUtf8().constData() << "]";
+            qtfbDebug(lcQtFirebaseService) << tab.toUtf8().constData() << "]";
             break;
 
         }
         default:{
-            qDebug() << "printFbVariant(): Type:" << v.TypeName(v.type()) << "not supported";
+            qtfbDebug(lcQtFirebaseService) << "printFbVariant(): Type:" << v.TypeName(v.type()) << "not supported";
             break;
         }
     }
@@ -169,7 +172,6 @@ QtFirebaseService::QtFirebaseService(QObject* parent):
     _ready(false),
     _initializing(false)
 {
-    __QTFIREBASE_ID = QString().sprintf("%8p", static_cast<void*> (this));
 }
 
 bool QtFirebaseService::ready() const
@@ -177,8 +179,21 @@ bool QtFirebaseService::ready() const
     return _ready;
 }
 
+static QString fromFirebaseString(const firebase::Variant &v)
+{
+    // Mutable strings know their length, no need to scan for the terminator again
+    if(v.type() == firebase::Variant::kTypeMutableString)
+    {
+        const std::string &str = v.mutable_string();
+        return QString::fromUtf8(str.data(), static_cast<int>(str.size()));
+    }
+    return QString::fromUtf8(v.string_value());
+}
+
 QVariant QtFirebaseService::fromFirebaseVariant(const firebase::Variant &v)
 {
+    // NOTE the source tree is only ever read through const references,
+    // every value is converted exactly once straight into its target container
     switch(v.type())
     {
         case firebase::Variant::kTypeNull:
@@ -190,46 +205,69 @@ QVariant QtFirebaseService::fromFirebaseVariant(const firebase::Variant &v)
         case firebase::Variant::kTypeBool:
             return QVariant(v.bool_value());
         case firebase::Variant::kTypeStaticString:
-            return QVariant(QString::fromUtf8(v.string_value()));
         case firebase::Variant::kTypeMutableString:
-            return QVariant(QString::fromUtf8(v.mutable_string().c_str()));
+            return QVariant(fromFirebaseString(v));
+        case firebase::Variant::kTypeStaticBlob:
+        case firebase::Variant::kTypeMutableBlob:
+            // NOTE copied, the QVariant usually outlives the variant tree (e.g. in QML)
+            return QVariant(QByteArray(reinterpret_cast<const char*>(v.blob_data()), static_cast<int>(v.blob_size())));
         case firebase::Variant::kTypeMap:{
-            std::map<firebase::Variant, firebase::Variant> srcMap = v.map();
+            const std::map<firebase::Variant, firebase::Variant> &srcMap = v.map();
             QVariantMap targetMap;
             for(std::map<firebase::Variant, firebase::Variant>::const_iterator it = srcMap.begin();it!=srcMap.end();++it)
             {
-                firebase::Variant key = it->first;
+                const firebase::Variant &key = it->first;
                 if(key.type()==firebase::Variant::kTypeStaticString ||
                         key.type()==firebase::Variant::kTypeMutableString)
                 {
-                    targetMap[QString::fromUtf8(key.string_value())] = fromFirebaseVariant(it->second);
+                    // Source keys are sorted already, so appending at the end is the right spot
+                    // (or close to it) and the insert does not have to search the whole map
+                    targetMap.insert(targetMap.cend(), fromFirebaseString(key), fromFirebaseVariant(it->second));
                 }
                 else
                 {
-                    qDebug() << "QtFirebaseService::fromFirebaseVariant:" << "QtFirebase does not support non string keys";
-                    qDebug() << "QtFirebaseService::fromFirebaseVariant:" << "Got key of type:" << key.TypeName(v.type());
+                    qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::fromFirebaseVariant:" << "QtFirebase does not support non string keys";
+                    qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::fromFirebaseVariant:" << "Got key of type:" << firebase::Variant::TypeName(key.type());
                     return QVariant();
                 }
             }
             return QVariant(targetMap);
         }
         case firebase::Variant::kTypeVector:{
-            std::vector<firebase::Variant> srcLst = v.vector();
+            const std::vector<firebase::Variant> &srcLst = v.vector();
             QVariantList targetLst;
+            targetLst.reserve(static_cast<int>(srcLst.size()));
             for(std::vector<firebase::Variant>::const_iterator it = srcLst.begin();it!=srcLst.end();++it)
             {
-                targetLst<<fromFirebaseVariant(*it);
+                targetLst.append(fromFirebaseVariant(*it));
             }
             return QVariant(targetLst);
         }
         default:{
-            qDebug() << "QtFirebaseService::fromFirebaseVariant type:" << v.TypeName(v.type()) << " not supported";
+            qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::fromFirebaseVariant type:" << firebase::Variant::TypeName(v.type()) << " not supported";
         }
     }
     return QVariant();
 }
 
-firebase::Variant QtFirebaseService::fromQtVariant(const QVariant &v)
+static firebase::Variant stringVariant(const char *data, int size)
+{
+    // NOTE built in place, no temporary std::string to copy from
+    firebase::Variant result{std::string()};
+    result.mutable_string().assign(data, static_cast<size_t>(size));
+    return result;
+}
+
+// One UTF-8 buffer for all strings of a conversion, each result string is allocated at its exact size
+typedef QVarLengthArray<char, 1024> Utf8Scratch;
+
+static firebase::Variant stringVariant(const QString &str, Utf8Scratch &scratch)
+{
+    scratch.resize(str.size() * 3);
+    return stringVariant(scratch.data(), QtFirebaseArena::encodeUtf8(str, scratch.data()));
+}
+
+static firebase::Variant convertQtVariant(const QVariant &v, Utf8Scratch &scratch)
 {
     switch(v.type())
     {
@@ -255,70 +293,138 @@ firebase::Variant QtFirebaseService::fromQtVariant(const QVariant &v)
             return firebase::Variant(static_cast<int64_t>(v.toDateTime().toMSecsSinceEpoch()));
         }
         case QVariant::String:{
-            std::string str(v.toString().toUtf8().constData());
-            return firebase::Variant(str);
+            return stringVariant(v.toString(), scratch);
         }
         case QVariant::ByteArray:{
-            std::string str(v.toByteArray().constData());
-            return firebase::Variant(str);
-        }
-        case QVariant::Map:{
-            QVariantMap srcMap = v.toMap();
-            std::map<std::string, firebase::Variant> targetMap;
-            for(QVariantMap::const_iterator it = srcMap.begin();it!=srcMap.end();++it)
-            {
-                targetMap[it.key().toUtf8().constData()] = fromQtVariant(it.value());
-            }
-            return firebase::Variant(targetMap);
+            // NOTE a string, not a blob: the Realtime Database only stores JSON and rejects blobs.
+            // Copied once and without stopping at the first NUL byte
+            const QByteArray bytes = v.toByteArray();
+            return stringVariant(bytes.constData(), bytes.size());
         }
         case QVariant::List:{
-            QVariantList srcLst = v.toList();
-            std::vector<firebase::Variant> targetLst;
+            const QVariantList srcLst = v.toList();
+            firebase::Variant result = firebase::Variant::EmptyVector();
+            std::vector<firebase::Variant> &targetLst = result.vector();
+            targetLst.reserve(static_cast<size_t>(srcLst.size()));
             for(QVariantList::const_iterator it = srcLst.begin();it!=srcLst.end();++it)
             {
-                targetLst.push_back(fromQtVariant(*it));
+                targetLst.push_back(convertQtVariant(*it, scratch));
             }
-            return firebase::Variant(targetLst);
+            return result;
         }
         default:{
-            if(v.userType() == qMetaTypeId<QJSValue>()) {
-                QVariantMap srcMap = v.toMap();
-                std::map<std::string, firebase::Variant> targetMap;
-                for(QVariantMap::const_iterator it = srcMap.begin();it!=srcMap.end();++it)
-                {
-                    targetMap[it.key().toUtf8().constData()] = fromQtVariant(it.value());
-                }
-                return firebase::Variant(targetMap);
-            } else {
-                qDebug() << "QtFirebaseService::fromQtVariant type:" << v.typeName() << "not supported";
+            if(v.type() != QVariant::Map && v.userType() != qMetaTypeId<QJSValue>()) {
+                qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::fromQtVariant type:" << v.typeName() << "not supported";
+                return firebase::Variant();
+            }
+
+            // Maps and JS objects, converted straight into the result instead of
+            // going through a std::map<std::string, Variant> that is copied afterwards
+            const QVariantMap srcMap = v.toMap();
+            firebase::Variant result = firebase::Variant::EmptyMap();
+            std::map<firebase::Variant, firebase::Variant> &targetMap = result.map();
+            for(QVariantMap::const_iterator it = srcMap.begin();it!=srcMap.end();++it)
+            {
+                targetMap.emplace_hint(targetMap.end(), stringVariant(it.key(), scratch), convertQtVariant(it.value(), scratch));
             }
+            return result;
         }
     }
+}
 
-    return firebase::Variant();
+firebase::Variant QtFirebaseService::fromQtVariant(const QVariant &v)
+{
+    Utf8Scratch scratch;
+    return convertQtVariant(v, scratch);
 }
 
-void QtFirebaseService::startInit()
+QJSValue QtFirebaseService::toJSValue(QJSEngine *engine, const firebase::Variant &v)
 {
-    if(qFirebase->ready())
+    switch(v.type())
     {
-        //Call init outside of constructor, otherwise signal readyChanged not emited
-        QTimer::singleShot(500, this, &QtFirebaseService::init);
+        case firebase::Variant::kTypeNull:
+            return QJSValue(QJSValue::NullValue);
+        case firebase::Variant::kTypeInt64:
+            return QJSValue(static_cast<double>(v.int64_value()));
+        case firebase::Variant::kTypeDouble:
+            return QJSValue(v.double_value());
+        case firebase::Variant::kTypeBool:
+            return QJSValue(v.bool_value());
+        case firebase::Variant::kTypeStaticString:
+        case firebase::Variant::kTypeMutableString:
+            return QJSValue(fromFirebaseString(v));
+        case firebase::Variant::kTypeStaticBlob:
+        case firebase::Variant::kTypeMutableBlob:
+            // ArrayBuffer
+            return engine->toScriptValue(QByteArray(reinterpret_cast<const char*>(v.blob_data()), static_cast<int>(v.blob_size())));
+        case firebase::Variant::kTypeMap:{
+            QJSValue object = engine->newObject();
+            const std::map<firebase::Variant, firebase::Variant> &srcMap = v.map();
+            for(std::map<firebase::Variant, firebase::Variant>::const_iterator it = srcMap.begin();it!=srcMap.end();++it)
+            {
+                const firebase::Variant &key = it->first;
+                if(key.type()==firebase::Variant::kTypeStaticString ||
+                        key.type()==firebase::Variant::kTypeMutableString)
+                {
+                    object.setProperty(fromFirebaseString(key), toJSValue(engine, it->second));
+                }
+                else
+                {
+                    qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::toJSValue:" << "skipping key of type:" << firebase::Variant::TypeName(key.type());
+                }
+            }
+            return object;
+        }
+        case firebase::Variant::kTypeVector:{
+            const std::vector<firebase::Variant> &srcLst = v.vector();
+            QJSValue array = engine->newArray(static_cast<uint>(srcLst.size()));
+            for(size_t i = 0; i < srcLst.size(); ++i)
+            {
+                array.setProperty(static_cast<quint32>(i), toJSValue(engine, srcLst[i]));
+            }
+            return array;
+        }
+        default:{
+            qtfbDebug(lcQtFirebaseService) << "QtFirebaseService::toJSValue type:" << firebase::Variant::TypeName(v.type()) << " not supported";
+        }
     }
-    else
-    {
-        connect(qFirebase, &QtFirebase::readyChanged, this, &QtFirebaseService::init);
+    return QJSValue();
+}
+
+void QtFirebaseService::startInit(const QtFirebaseInitScheduler::Work &nativeInit)
+{
+    //init is always called outside of constructor, otherwise signal readyChanged not emited
+    qFirebase->initScheduler()->addModule(QString::fromLatin1(metaObject()->className()),
+                                          nativeInit ? QtFirebaseInitScheduler::AnyThread : QtFirebaseInitScheduler::GuiThread,
+                                          nativeInit, this, [this]() { init(); });
+
+    if(!qFirebase->ready())
         qFirebase->requestInit();
-    }
-    connect(qFirebase, &QtFirebase::futureEvent, this, &QtFirebaseService::onFutureEvent);
+}
+
+QtFirebaseFutureHandle QtFirebaseService::addFuture(const QString &eventId, const firebase::FutureBase &future, int timeout, QtFirebaseMetrics::Operation operation)
+{
+    // Completion is delivered to this service only, no need to match eventId against other services
+    return qFirebase->addFuture(future, this, [this, eventId](QtFirebaseFutureHandle handle, const firebase::FutureBase &completed) {
+        Q_UNUSED(handle)
+        onFutureEvent(eventId, completed);
+    }, timeout, operation);
+}
+
+void QtFirebaseService::onFutureEvent(QString eventId, firebase::FutureBase future)
+{
+    Q_UNUSED(future)
+    qtfbDebug(lcQtFirebaseService) << this << "::onFutureEvent" << "unhandled future event" << eventId;
 }
 
 void QtFirebaseService::setReady(bool value)
 {
-    qDebug() << this << "::setReady" << value;
+    qtfbDebug(lcQtFirebaseService) << this << "::setReady" << value;
 
     if (_ready != value) {
         _ready = value;
+        if(_ready)
+            qFirebase->recordStartup(QString::fromLatin1(metaObject()->className()));
         emit readyChanged();
     }
 }
@@ -1,6 +1,7 @@
 #ifndef QTFIREBASE_SERVICE_H
 #define QTFIREBASE_SERVICE_H
 #include <QObject>
+#include <QJSValue>
 #include "qtfirebase.h"
 #include "firebase/variant.h"
 
@@ -8,6 +9,8 @@ template <typename ResultType> const ResultType* result(const void* p) {
   return p==nullptr ? nullptr : static_cast<const ResultType*>(p);
 }
 
+class QJSEngine;
+
 void printQtVariant(const QVariant& v, const QString& tab = QString());
 void printFbVariant(const firebase::Variant& v, const QString& tab = QString());
 
@@ -19,20 +22,27 @@ public:
     QtFirebaseService(QObject* parent);
     bool ready() const;
     static QVariant fromFirebaseVariant(const firebase::Variant& v);
+    // QByteArray becomes a string, the Realtime Database only takes JSON values
     static firebase::Variant fromQtVariant(const QVariant& v);
+    // Builds JS objects and arrays straight in engine. Integers become JS numbers (exact up to 2^53)
+    static QJSValue toJSValue(QJSEngine* engine, const firebase::Variant& v);
 signals:
     void readyChanged();
 
 protected:
 
-    void startInit();
+    // Schedules init() next to the other modules once the App exists.
+    // nativeInit, if given, runs first on a pool thread and must only do thread safe SDK calls.
+    // It must not touch this service, it returns the step that stores its result instead
+    void startInit(const QtFirebaseInitScheduler::Work &nativeInit = QtFirebaseInitScheduler::Work());
+    QtFirebaseFutureHandle addFuture(const QString &eventId, const firebase::FutureBase &future, int timeout = 0,
+                                     QtFirebaseMetrics::Operation operation = QtFirebaseMetrics::None);
     virtual void setReady(bool value);
     virtual bool initializing() const;
     virtual void setInitializing(bool value);
     virtual void init() = 0;
-    virtual void onFutureEvent(QString eventId, firebase::FutureBase future) = 0;
+    virtual void onFutureEvent(QString eventId, firebase::FutureBase future);
 
-    QString __QTFIREBASE_ID;
     bool _ready;
     bool _initializing;
 };
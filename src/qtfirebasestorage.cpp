@@ -1,97 +1,104 @@
 #include "qtfirebasestorage.h"
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QPointer>
 #include <firebase/storage/metadata.h>
 namespace store = ::firebase::storage;
 
 QtFirebaseStorage* QtFirebaseStorage::self = 0;
 
+namespace StorageActions {
+    const QString Save = QStringLiteral("save");
+    const QString GetUrl = QStringLiteral("getUrl");
+    const QString Delete = QStringLiteral("delete");
+}
+
+static QtFirebaseMetrics::Operation metricsOperation(const QString &action)
+{
+    if(action == StorageActions::Save)
+        return QtFirebaseMetrics::StorageSave;
+    if(action == StorageActions::GetUrl)
+        return QtFirebaseMetrics::StorageGetUrl;
+    if(action == StorageActions::Delete)
+        return QtFirebaseMetrics::StorageDelete;
+    return QtFirebaseMetrics::None;
+}
+
 QtFirebaseStorage::QtFirebaseStorage(QObject *parent) : QtFirebaseService(parent),
     m_storage(nullptr)
 {
-    startInit();
+    // GetInstance only takes the SDK's own lock, no need to block the GUI thread with it
+    // NOTE this is only copied into the Task, which runs on the GUI thread while this is alive
+    startInit([this]() -> QtFirebaseInitScheduler::Task {
+        store::Storage *storage = store::Storage::GetInstance(qFirebase->firebaseApp());
+        return [this, storage]() { m_storage = storage; };
+    });
 }
 
 void QtFirebaseStorage::init()
 {
     if(!qFirebase->ready()) {
-        qDebug() << self << "::init" << "base not ready";
+        qtfbDebug(lcQtFirebaseStorage) << self << "::init" << "base not ready";
         return;
     }
 
     if(!ready() && !initializing()) {
         setInitializing(true);
-        m_storage = store::Storage::GetInstance(qFirebase->firebaseApp());
-        qDebug() << self << "::init" << "native initialized";
+        if(!m_storage)
+            m_storage = store::Storage::GetInstance(qFirebase->firebaseApp());
+        qtfbDebug(lcQtFirebaseStorage) << self << "::init" << "native initialized";
         setInitializing(false);
         setReady(true);
     }
 }
 
-void QtFirebaseStorage::onFutureEvent(QString eventId, firebase::FutureBase future)
+void QtFirebaseStorage::addFuture(const QString &action, QtFirebaseStorageRequest *request, const firebase::FutureBase &future)
 {
-    if(!eventId.startsWith(__QTFIREBASE_ID))
-        return;
-
-    qDebug() << self << "::onFutureEvent" << eventId;
+    // Operations are keyed by their future handle, so any number of requests
+    // (each running any action) can be in flight at the same time
+    QPointer<QtFirebaseStorageRequest> target(request);
+    const QtFirebaseFutureHandle handle = qFirebase->addFuture(future, this, [this, action, target](QtFirebaseFutureHandle futureHandle, const firebase::FutureBase &completed) {
+        {
+            QMutexLocker locker(&m_futureMutex);
+            m_requests.remove(futureHandle);
+        }
 
-    QMutexLocker locker(&m_futureMutex);
-    QMap<QString, QtFirebaseStorageRequest*>::iterator it = m_requests.find(eventId);
-    if(it!=m_requests.end() && it.value()!=nullptr)
-    {
-        QtFirebaseStorageRequest* request = it.value();
-        m_requests.erase(it);
-        QString id = eventId.right(eventId.size()-prefix().size());
-        request->onFutureEvent(id, future);
-    }
-    else
-    {
-        qDebug() << this << "::onFutureEvent internal error, no request object found";
-    }
-}
+        qtfbDebug(lcQtFirebaseStorage) << self << "::onFutureEvent" << action << futureHandle;
 
-QtFirebaseStorageRequest *QtFirebaseStorage::request(const QString &futureKey) const
-{
-    auto it = m_requests.find(futureKey);
-    return it!=m_requests.end() ? *it : nullptr;
-}
+        // Called without holding the mutex, the request may start a new operation right away
+        if(target)
+            target->onFutureEvent(action, completed);
+        else
+            qtfbDebug(lcQtFirebaseStorage) << this << "::onFutureEvent request object is gone, dropping" << action;
+    }, request->timeout(), metricsOperation(action));
 
-void QtFirebaseStorage::addFuture(QString requestId, QtFirebaseStorageRequest *request, firebase::FutureBase future)
-{
-    QString futureKey = prefix() + requestId;
-    qFirebase->addFuture(futureKey, future);
-    m_requests[futureKey] = request;
+    QMutexLocker locker(&m_futureMutex);
+    m_requests.insert(handle, request);
 }
 
 void QtFirebaseStorage::unregisterRequest(QtFirebaseStorageRequest *request)
 {
     QMutexLocker locker(&m_futureMutex);
-    for(QMap<QString, QtFirebaseStorageRequest*>::iterator it = m_requests.begin();it!=m_requests.end();++it)
+    for(auto it = m_requests.begin(); it != m_requests.end();)
     {
         if(it.value() == request)
         {
-            m_requests.erase(it);
-            break;
+            qFirebase->removeFuture(it.key());
+            it = m_requests.erase(it);
+        }
+        else
+        {
+            ++it;
         }
     }
 }
 
-QString QtFirebaseStorage::prefix() const
-{
-    return __QTFIREBASE_ID + QStringLiteral(".db.");
-}
-
 //================QtFirebaseDatabaseRequest===================
 
-namespace StorageActions {
-    const QString Save = QStringLiteral("save");
-    const QString GetUrl = QStringLiteral("getUrl");
-    const QString Delete = QStringLiteral("delete");
-}
-
 QtFirebaseStorageRequest::QtFirebaseStorageRequest():
     m_inComplexRequest(false)
     ,m_complete(true)
+    ,m_timeout(0)
 {
     clearError();
 }
@@ -192,14 +199,19 @@ QString QtFirebaseStorageRequest::childKey() const
 
 void QtFirebaseStorageRequest::onFutureEvent(QString eventId, firebase::FutureBase future)
 {
-    if(future.status() != firebase::kFutureStatusComplete)
+    if(future.status() == firebase::kFutureStatusPending)
+    {
+        qtfbDebug(lcQtFirebaseStorage) << this << "::onFutureEvent " << "ERROR: Action timed out after" << m_timeout << "ms";
+        setError(QtFirebaseStorage::ErrorTimeout, QStringLiteral("Operation timed out"));
+    }
+    else if(future.status() != firebase::kFutureStatusComplete)
     {
-        qDebug() << this << "::onFutureEvent " << "ERROR: Action failed with status: " << future.status();
+        qtfbDebug(lcQtFirebaseStorage) << this << "::onFutureEvent " << "ERROR: Action failed with status: " << future.status();
         setError(QtFirebaseStorage::ErrorUnknown);
     }
     else if (future.error() != firebase::storage::kErrorNone)
     {
-        qDebug() << this << "::onFutureEvent Error occured in result:" << future.error() << future.error_message();
+        qtfbDebug(lcQtFirebaseStorage) << this << "::onFutureEvent Error occured in result:" << future.error() << future.error_message();
         setError(future.error(), future.error_message());
     }
     else if(eventId == StorageActions::GetUrl)
@@ -247,6 +259,20 @@ bool QtFirebaseStorageRequest::running() const
     return !m_complete;
 }
 
+int QtFirebaseStorageRequest::timeout() const
+{
+    return m_timeout;
+}
+
+void QtFirebaseStorageRequest::setTimeout(int timeout)
+{
+    if(m_timeout != timeout)
+    {
+        m_timeout = timeout;
+        emit timeoutChanged();
+    }
+}
+
 void QtFirebaseStorageRequest::onRun()
 {
     exec();
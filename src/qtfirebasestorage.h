@@ -3,6 +3,7 @@
 
 #include "qtfirebaseservice.h"
 #include "firebase/storage.h"
+#include <QHash>
 #include <QMutex>
 
 #ifdef QTFIREBASE_BUILD_STORAGE
@@ -21,13 +22,14 @@ public:
     static QtFirebaseStorage* instance() {
         if(self == 0) {
             self = new QtFirebaseStorage(0);
-            qDebug() << self << "::instance" << "singleton";
+            qtfbDebug(lcQtFirebaseStorage) << self << "::instance" << "singleton";
         }
         return self;
     }
 
     enum Error
     {
+        ErrorTimeout = firebase::storage::kErrorNone-1, // QtFirebase: the request timeout passed
         ErrorNone = firebase::storage::kErrorNone,
         ErrorUnknown = firebase::storage::kErrorUnknown,
         ErrorObjectNotFound = firebase::storage::kErrorObjectNotFound,
@@ -46,19 +48,16 @@ public:
 private:
     explicit QtFirebaseStorage(QObject *parent = 0);
     void init() override;
-    void onFutureEvent(QString eventId, firebase::FutureBase future) override;
 
-    QString futureKey(QtFirebaseStorageRequest* request) const;
-    QtFirebaseStorageRequest* request(const QString& futureKey) const;
-    void addFuture(QString requestId, QtFirebaseStorageRequest* request, firebase::FutureBase future);
+    void addFuture(const QString& action, QtFirebaseStorageRequest* request, const firebase::FutureBase& future);
     void unregisterRequest(QtFirebaseStorageRequest* request);
-    QString prefix() const;
 private:
     static QtFirebaseStorage* self;
     Q_DISABLE_COPY(QtFirebaseStorage)
 
     firebase::storage::Storage* m_storage;
-    QMap<QString, QtFirebaseStorageRequest*> m_requests;
+    // In-flight operations, every operation has its own future handle
+    QHash<QtFirebaseFutureHandle, QtFirebaseStorageRequest*> m_requests;
     QMutex m_futureMutex;
 
     friend class QtFirebaseStorageRequest;
@@ -68,6 +67,8 @@ class QtFirebaseStorageRequest: public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    // Milliseconds before a running operation fails with ErrorTimeout, 0 (default) waits forever
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
 public:
     QtFirebaseStorageRequest();
     ~QtFirebaseStorageRequest();
@@ -84,6 +85,8 @@ public slots:
 
     //State
     bool running() const;
+    int timeout() const;
+    void setTimeout(int timeout);
     int errorId() const;
     bool hasError() const;
     QString errorMsg() const;
@@ -96,6 +99,7 @@ public:
 signals:
     void completed(bool success);
     void runningChanged();
+    void timeoutChanged();
     void snapshotChanged();
 private slots:
     void onRun();
@@ -109,6 +113,7 @@ private:
     firebase::storage::StorageReference m_storageRef;
     QString m_action;
     bool m_complete;
+    int m_timeout;
     QString m_pushChildKey;
     int m_errId;
     QString m_errMsg;
@@ -0,0 +1,118 @@
+#include "qtfirebasetimerwheel.h"
+
+QtFirebaseTimerWheel::QtFirebaseTimerWheel(int tickMs):
+    m_tickMs(qMax(1, tickMs)),
+    m_currentTick(0)
+{
+}
+
+int QtFirebaseTimerWheel::tickInterval() const
+{
+    return m_tickMs;
+}
+
+bool QtFirebaseTimerWheel::isEmpty() const
+{
+    return m_pending.isEmpty();
+}
+
+void QtFirebaseTimerWheel::schedule(QtFirebaseFutureHandle handle, qint64 deadline, qint64 now)
+{
+    // An idle wheel jumps straight to 'now' instead of stepping through the idle ticks
+    if(m_pending.isEmpty())
+        m_currentTick = qMax(m_currentTick, now / m_tickMs);
+
+    // Round up, a timer never fires before its deadline
+    const qint64 expiry = qMax(m_currentTick + 1, (deadline + m_tickMs - 1) / m_tickMs);
+
+    cancel(handle);
+    place(Timer { handle, expiry });
+}
+
+void QtFirebaseTimerWheel::cancel(QtFirebaseFutureHandle handle)
+{
+    auto it = m_pending.find(handle);
+    if(it == m_pending.end())
+        return;
+
+    unlink(it.value());
+    m_pending.erase(it);
+}
+
+void QtFirebaseTimerWheel::advance(qint64 now, QVector<QtFirebaseFutureHandle> &expired)
+{
+    const qint64 target = now / m_tickMs;
+
+    while(m_currentTick < target)
+    {
+        if(m_pending.isEmpty())
+        {
+            m_currentTick = target;
+            break;
+        }
+
+        m_currentTick++;
+
+        // Cascade every level that wrapped around with this tick, highest first
+        int level = 0;
+        while(level + 1 < Levels && (m_currentTick & ((Q_INT64_C(1) << ((level + 1) * SlotBits)) - 1)) == 0)
+            level++;
+        for(int l = level; l > 0; --l)
+            cascade(l);
+
+        QVector<Timer> slot;
+        slot.swap(m_slots[0][m_currentTick & (Slots - 1)]);
+        for(const Timer &timer : slot)
+        {
+            if(timer.expiry <= m_currentTick)
+            {
+                m_pending.remove(timer.handle);
+                expired.append(timer.handle);
+            }
+            else
+            {
+                place(timer);
+            }
+        }
+    }
+}
+
+void QtFirebaseTimerWheel::place(const Timer &timer)
+{
+    // Deadlines beyond the top level's span are parked in the top level and re-placed when it cascades
+    const qint64 maxDelta = (Q_INT64_C(1) << (Levels * SlotBits)) - 1;
+    const qint64 expiry = qMin(timer.expiry, m_currentTick + maxDelta);
+    const qint64 delta = expiry - m_currentTick;
+
+    int level = 0;
+    while(level + 1 < Levels && delta >= (Q_INT64_C(1) << ((level + 1) * SlotBits)))
+        level++;
+
+    const int index = static_cast<int>((expiry >> (level * SlotBits)) & (Slots - 1));
+    QVector<Timer> &slot = m_slots[level][index];
+    m_pending.insert(timer.handle, Location { level, index, slot.size() });
+    slot.append(timer);
+}
+
+void QtFirebaseTimerWheel::unlink(const Location &location)
+{
+    // Swap with the last timer of the slot and drop that, the order within a slot does not matter
+    QVector<Timer> &slot = m_slots[location.level][location.index];
+    const int last = slot.size() - 1;
+    if(location.position != last)
+    {
+        slot[location.position] = slot.at(last);
+        m_pending[slot.at(location.position).handle].position = location.position;
+    }
+    slot.removeLast();
+}
+
+void QtFirebaseTimerWheel::cascade(int level)
+{
+    const int index = static_cast<int>((m_currentTick >> (level * SlotBits)) & (Slots - 1));
+
+    QVector<Timer> slot;
+    slot.swap(m_slots[level][index]);
+    for(const Timer &timer : slot)
+        place(timer);
+}
@@ -0,0 +1,64 @@
+#ifndef QTFIREBASE_TIMER_WHEEL_H
+#define QTFIREBASE_TIMER_WHEEL_H
+
+#include "qtfirebasefutureregistry.h"
+
+#include <QHash>
+#include <QVector>
+
+/*
+ * Hierarchical timer wheel for future deadlines
+ *
+ * Four levels of 64 slots. Level 0 has one slot per tick, every higher level
+ * covers 64 times the span of the level below. Timers are cascaded down a level
+ * when the lower level wraps around. Scheduling and cancelling are O(1),
+ * advancing costs one step per elapsed tick (skipped entirely while empty).
+ * Times are in milliseconds on a caller provided monotonic clock.
+ */
+class QtFirebaseTimerWheel
+{
+public:
+    explicit QtFirebaseTimerWheel(int tickMs = 16);
+
+    int tickInterval() const;
+    bool isEmpty() const;
+
+    void schedule(QtFirebaseFutureHandle handle, qint64 deadline, qint64 now);
+    void cancel(QtFirebaseFutureHandle handle);
+
+    // Moves the wheel forward to 'now' and appends the handles that expired
+    void advance(qint64 now, QVector<QtFirebaseFutureHandle> &expired);
+
+private:
+    enum {
+        SlotBits = 6,
+        Slots = 1 << SlotBits,
+        Levels = 4
+    };
+
+    struct Timer
+    {
+        QtFirebaseFutureHandle handle;
+        qint64 expiry; // in ticks
+    };
+
+    // Where a live timer sits, so it can be taken out of its slot right away
+    struct Location
+    {
+        int level;
+        int index;
+        int position;
+    };
+
+    void place(const Timer &timer);
+    void unlink(const Location &location);
+    void cascade(int level);
+
+    int m_tickMs;
+    qint64 m_currentTick;
+    QVector<Timer> m_slots[Levels][Slots];
+    // Every live timer, and only those, is in exactly one slot
+    QHash<QtFirebaseFutureHandle, Location> m_pending;
+};
+
+#endif // QTFIREBASE_TIMER_WHEEL_H
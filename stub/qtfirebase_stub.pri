@@ -9,6 +9,7 @@ QML_IMPORT_PATH += $$PWD
 
 HEADERS += \
     $$QTFIREBASE_STUB_PATH/src/qtfirebase.h \
+    $$QTFIREBASE_STUB_PATH/src/qtfirebasemetrics.h \
     $$QTFIREBASE_STUB_PATH/src/qtfirebaseservice.h \
     \
 
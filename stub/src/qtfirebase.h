@@ -7,12 +7,15 @@
 #define qFirebase (static_cast<QtFirebase *>(QtFirebase::instance()))
 
 #include <QObject>
+#include <QVariantList>
 
 class QtFirebase : public QObject
 {
     Q_OBJECT
 
     Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
+    Q_PROPERTY(QVariantList startupTimeline READ startupTimeline NOTIFY startupTimelineChanged)
+    Q_PROPERTY(bool modulesReady READ modulesReady NOTIFY modulesReadyChanged)
 
 public:
     explicit QtFirebase(QObject* parent = nullptr) { Q_UNUSED(parent); }
@@ -28,8 +31,14 @@ public:
 
     bool checkInstance(const char *function) { Q_UNUSED(function); return false; }
 
+    QVariantList startupTimeline() const { return QVariantList(); }
+    void recordStartup(const QString &module) { Q_UNUSED(module); }
+    bool modulesReady() const { return false; }
+
 signals:
     void readyChanged();
+    void startupTimelineChanged();
+    void modulesReadyChanged();
 
 public slots:
     void requestInit() {}
@@ -30,7 +30,18 @@
 #include <src/qtfirebasestorage.h>
 # endif // QTFIREBASE_BUILD_STORAGE
 
+#include <src/qtfirebasemetrics.h>
+
 #include <qqml.h>
+#include <QQmlEngine>
+
+static QObject *QtFirebaseMetricsProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(scriptEngine)
+    // Process wide object, QML must not take ownership
+    engine->setObjectOwnership(qFirebaseMetrics, QQmlEngine::CppOwnership);
+    return qFirebaseMetrics;
+}
 
 #if defined(QTFIREBASE_BUILD_ALL) || defined(QTFIREBASE_BUILD_DATABASE)
 static QObject *QtFirebaseDatabaseProvider(QQmlEngine *engine, QJSEngine *scriptEngine)
@@ -54,6 +65,7 @@ void QtFirebasePlugin::registerTypes(const char *uri)
 {
     // @uri QtFirebase
     qmlRegisterType<QtFirebaseGetInstanceRequest>(uri, 1, 0, "GetInstanceRequest");
+    qmlRegisterSingletonType<QtFirebaseMetrics>(uri, 1, 0, "Metrics", QtFirebaseMetricsProvider);
 
 #if defined(QTFIREBASE_BUILD_ALL) || defined(QTFIREBASE_BUILD_ANALYTICS)
     qmlRegisterType<QtFirebaseAnalytics>(uri, 1, 0, "Analytics");
@@ -84,6 +96,8 @@ void QtFirebasePlugin::registerTypes(const char *uri)
     qmlRegisterSingletonType<QtFirebaseDatabase>("QtFirebase", 1, 0, "Database", QtFirebaseDatabaseProvider);
     qmlRegisterUncreatableType<QtFirebaseDatabaseQuery>("QtFirebase", 1, 0, "DatabaseQuery", "Get query object from DatabaseRequest, do not create it");
     qmlRegisterType<QtFirebaseDatabaseRequest>("QtFirebase", 1, 0, "DatabaseRequest");
+    qmlRegisterType<QtFirebaseDatabaseListener>("QtFirebase", 1, 0, "DatabaseListener");
+    qmlRegisterType<QtFirebaseDatabaseListModel>("QtFirebase", 1, 0, "DatabaseListModel");
     qmlRegisterUncreatableType<QtFirebaseDataSnapshot>("QtFirebase", 1, 0, "DataSnapshot", "Get snapshot object from DatabaseRequest, do not create it");
 #endif
 
@@ -14,6 +14,7 @@ class QtFirebaseAuth: public QObject
     Q_OBJECT
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
     Q_PROPERTY(bool signedIn READ signedIn NOTIFY signedInChanged)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
 public:
     static QtFirebaseAuth *instance()
     {
@@ -25,6 +26,7 @@ public:
     }
     enum Error
     {
+        AuthErrorTimeout = -1,
         AuthErrorNone,
         AuthErrorUnimplemented,
         AuthErrorFailure
@@ -51,6 +53,8 @@ public slots:
     //Status
     bool signedIn() const{return false;}
     bool running() const{return false;}
+    int timeout() const{return 0;}
+    void setTimeout(int timeout){Q_UNUSED(timeout);}
     int errorId() const{return AuthErrorNone;}
     QString errorMsg() const{return QString();}
 
@@ -63,6 +67,7 @@ public slots:
 signals:
     void signedInChanged();
     void runningChanged();
+    void timeoutChanged();
     void completed(bool success, int actionId);
     void passwordResetEmailSent();
 
@@ -1,6 +1,8 @@
 #ifndef QTFIREBASE_DATABASE_H
 #define QTFIREBASE_DATABASE_H
+#include <QAbstractListModel>
 #include <QObject>
+#include <QJSValue>
 #include <QVariant>
 
 #ifdef QTFIREBASE_BUILD_DATABASE
@@ -16,6 +18,12 @@ class QtFirebaseDatabase : public QtFirebaseService
 {
     Q_OBJECT
     typedef QSharedPointer<QtFirebaseDatabase> Ptr;
+    Q_PROPERTY(int cacheTtl READ cacheTtl WRITE setCacheTtl NOTIFY cacheTtlChanged)
+    Q_PROPERTY(int cacheBudget READ cacheBudget WRITE setCacheBudget NOTIFY cacheBudgetChanged)
+    Q_PROPERTY(int cacheBytes READ cacheBytes NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheHits READ cacheHits NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheMisses READ cacheMisses NOTIFY cacheStatsChanged)
+    Q_PROPERTY(int cacheCoalesced READ cacheCoalesced NOTIFY cacheStatsChanged)
 public:
     static QtFirebaseDatabase* instance() {
         if(self == 0) {
@@ -26,6 +34,7 @@ public:
 
     enum Error
     {
+        ErrorTimeout = -1,
         ErrorNone,
         ErrorDisconnected,
         ErrorExpiredToken,
@@ -50,6 +59,23 @@ public:
     void init() { }
     void onFutureEvent(QString eventId, int future) { Q_UNUSED(eventId); Q_UNUSED(future); }
 
+    int cacheTtl() const { return 0; }
+    void setCacheTtl(int ttl) { Q_UNUSED(ttl); }
+    int cacheBudget() const { return 0; }
+    void setCacheBudget(int bytes) { Q_UNUSED(bytes); }
+    int cacheBytes() const { return 0; }
+    int cacheHits() const { return 0; }
+    int cacheMisses() const { return 0; }
+    int cacheCoalesced() const { return 0; }
+public slots:
+    void clearCache() { }
+    void invalidateCache(const QString& path) { Q_UNUSED(path); }
+    void resetCacheStats() { }
+signals:
+    void cacheTtlChanged();
+    void cacheBudgetChanged();
+    void cacheStatsChanged();
+
 private:
     explicit QtFirebaseDatabase(QObject *parent = 0){Q_UNUSED(parent);}
     static QtFirebaseDatabase* self;
@@ -66,9 +92,22 @@ public slots:
     bool exists() const{return false;}
     QString key() const{return QString();}
     QVariant value() const{return QVariant();}
+    QVariant valueAt(const QString& path) const{Q_UNUSED(path); return QVariant();}
+    QJSValue jsValue() const{return QJSValue();}
+    QJSValue jsValueAt(const QString& path) const{Q_UNUSED(path); return QJSValue();}
     QByteArray jsonString() const{return QByteArray();}
+    QByteArray compactJsonString() const{return QByteArray();}
+    QVariantList orderedEntries() const{return QVariantList();}
+    QByteArray orderedJsonString() const{return QByteArray();}
+    QByteArray compactOrderedJsonString() const{return QByteArray();}
     bool hasChildren() const{return false;}
     bool valid() const{return false;}
+    bool equals(QtFirebaseDataSnapshot* other) const{Q_UNUSED(other); return false;}
+    QtFirebaseDataSnapshot* child(const QString& path){Q_UNUSED(path); return nullptr;}
+    int childrenCount() const{return 0;}
+    QtFirebaseDataSnapshot* getChild(int i){Q_UNUSED(i); return nullptr;}
+    QVariant priority() const{return QVariant();}
+    bool hasChild(const QString& path) const{Q_UNUSED(path); return false;}
 };
 
 class QtFirebaseDatabaseRequest;
@@ -97,6 +136,7 @@ class QtFirebaseDatabaseRequest: public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
     Q_PROPERTY(QtFirebaseDataSnapshot* snapshot READ snapshot NOTIFY snapshotChanged)
 public slots:
     //Data request
@@ -123,6 +163,8 @@ public slots:
 
     //State
     bool running() const{return false;}
+    int timeout() const{return 0;}
+    void setTimeout(int timeout){Q_UNUSED(timeout);}
     int errorId() const{return 0;}
     bool hasError() const{return false;}
     QString errorMsg() const{return QString();}
@@ -133,10 +175,108 @@ public slots:
 signals:
     void completed(bool success);
     void runningChanged();
+    void timeoutChanged();
     void snapshotChanged();
 
 };
 
+class QtFirebaseDatabaseListener: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(bool valueEvents READ valueEvents WRITE setValueEvents NOTIFY valueEventsChanged)
+    Q_PROPERTY(bool childEvents READ childEvents WRITE setChildEvents NOTIFY childEventsChanged)
+    Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int errorId READ errorId NOTIFY cancelled)
+    Q_PROPERTY(QString errorMsg READ errorMsg NOTIFY cancelled)
+public:
+    QtFirebaseDatabaseListener(QObject* parent = nullptr) : QObject(parent){}
+
+    QString path() const{return QString();}
+    void setPath(const QString& path){Q_UNUSED(path);}
+    bool valueEvents() const{return false;}
+    void setValueEvents(bool value){Q_UNUSED(value);}
+    bool childEvents() const{return true;}
+    void setChildEvents(bool value){Q_UNUSED(value);}
+    bool active() const{return false;}
+    int errorId() const{return 0;}
+    QString errorMsg() const{return QString();}
+public slots:
+    void start(){}
+    void stop(){}
+
+    //Filters
+    QtFirebaseDatabaseQuery* orderByKey(){return nullptr;}
+    QtFirebaseDatabaseQuery* orderByValue(){return nullptr;}
+    QtFirebaseDatabaseQuery* orderByChild(const QString& path){Q_UNUSED(path);return nullptr;}
+    QtFirebaseDatabaseQuery* orderByPriority(){return nullptr;}
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* limitToFirst(size_t limit){Q_UNUSED(limit); return nullptr;}
+    QtFirebaseDatabaseQuery* limitToLast(size_t limit){Q_UNUSED(limit); return nullptr;}
+signals:
+    void pathChanged();
+    void valueEventsChanged();
+    void childEventsChanged();
+    void activeChanged();
+    void valueChanged(QtFirebaseDataSnapshot* snapshot);
+    void childAdded(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childChanged(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childMoved(QtFirebaseDataSnapshot* snapshot, const QString& previousChildKey);
+    void childRemoved(QtFirebaseDataSnapshot* snapshot);
+    void cancelled(int errorId, const QString& errorMsg);
+};
+
+class QtFirebaseDatabaseListModel: public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int errorId READ errorId NOTIFY cancelled)
+    Q_PROPERTY(QString errorMsg READ errorMsg NOTIFY cancelled)
+public:
+    QtFirebaseDatabaseListModel(QObject* parent = nullptr) : QAbstractListModel(parent){}
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override{Q_UNUSED(parent); return 0;}
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override{Q_UNUSED(index); Q_UNUSED(role); return QVariant();}
+
+    QString path() const{return QString();}
+    void setPath(const QString& path){Q_UNUSED(path);}
+    bool active() const{return false;}
+    int count() const{return 0;}
+    int errorId() const{return 0;}
+    QString errorMsg() const{return QString();}
+public slots:
+    void start(){}
+    void stop(){}
+    int indexOf(const QString& key) const{Q_UNUSED(key); return -1;}
+    QVariant get(int row) const{Q_UNUSED(row); return QVariant();}
+
+    //Filters
+    QtFirebaseDatabaseQuery* orderByKey(){return nullptr;}
+    QtFirebaseDatabaseQuery* orderByValue(){return nullptr;}
+    QtFirebaseDatabaseQuery* orderByChild(const QString& path){Q_UNUSED(path);return nullptr;}
+    QtFirebaseDatabaseQuery* orderByPriority(){return nullptr;}
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* startAt(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* endAt(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value){Q_UNUSED(order_value); return nullptr;}
+    QtFirebaseDatabaseQuery* equalTo(QVariant order_value, const QString& child_key){Q_UNUSED(order_value); Q_UNUSED(child_key); return nullptr;}
+    QtFirebaseDatabaseQuery* limitToFirst(size_t limit){Q_UNUSED(limit); return nullptr;}
+    QtFirebaseDatabaseQuery* limitToLast(size_t limit){Q_UNUSED(limit); return nullptr;}
+signals:
+    void pathChanged();
+    void activeChanged();
+    void countChanged();
+    void cancelled(int errorId, const QString& errorMsg);
+};
+
 #endif //QTFIREBASE_BUILD_DATABASE
 
 #endif // QTFIREBASE_DATABASE_H
@@ -0,0 +1,37 @@
+#ifndef QTFIREBASE_METRICS_H
+#define QTFIREBASE_METRICS_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#if defined(qFirebaseMetrics)
+#undef qFirebaseMetrics
+#endif
+#define qFirebaseMetrics (static_cast<QtFirebaseMetrics *>(QtFirebaseMetrics::instance()))
+
+class QtFirebaseMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static QtFirebaseMetrics *instance()
+    {
+        static QtFirebaseMetrics *self = new QtFirebaseMetrics();
+        return self;
+    }
+
+    Q_INVOKABLE QVariantMap snapshot() const { return QVariantMap(); }
+    Q_INVOKABLE QVariantMap operation(const QString &name) const { Q_UNUSED(name); return QVariantMap(); }
+    Q_INVOKABLE QStringList operations() const { return QStringList(); }
+    Q_INVOKABLE double percentile(const QString &name, double percentile) const { Q_UNUSED(name); Q_UNUSED(percentile); return 0.0; }
+    Q_INVOKABLE QVariantMap dispatch() const { return QVariantMap(); }
+    Q_INVOKABLE void reset() {}
+    Q_INVOKABLE QString toJson() const { return QString(); }
+
+private:
+    explicit QtFirebaseMetrics(QObject *parent = nullptr) : QObject(parent) {}
+    Q_DISABLE_COPY(QtFirebaseMetrics)
+};
+
+#endif // QTFIREBASE_METRICS_H
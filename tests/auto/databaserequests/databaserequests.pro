@@ -0,0 +1,8 @@
+TARGET = tst_databaserequests
+
+QTFIREBASE_CONFIG += database
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_databaserequests.cpp \
+    \
@@ -0,0 +1,105 @@
+#include "src/qtfirebasedatabase.h"
+#include "testapp.h"
+
+#include <QtTest>
+
+/*
+ * Many DatabaseRequests in flight at once against a Realtime Database emulator
+ *
+ *   firebase emulators:start --only database
+ *   QTFIREBASE_TEST_DATABASE_URL="http://localhost:9000?ns=qtfirebase-test" ./tst_databaserequests
+ */
+class tst_DatabaseRequests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void overlappingGets_data();
+    void overlappingGets();
+};
+
+namespace {
+    const int Items = 10000;
+    const QString Root = QStringLiteral("qtfirebase-stress");
+
+    QString itemKey(int i)
+    {
+        return QStringLiteral("item%1").arg(i, 5, 10, QLatin1Char('0'));
+    }
+}
+
+void tst_DatabaseRequests::initTestCase()
+{
+    const QString url = QString::fromLocal8Bit(qgetenv("QTFIREBASE_TEST_DATABASE_URL"));
+    if(url.isEmpty())
+        QSKIP("QTFIREBASE_TEST_DATABASE_URL is not set, start the database emulator and point it there");
+
+    QVERIFY(TestApp::init(url));
+    QTRY_VERIFY(qFirebaseDatabase->ready());
+
+    QVariantMap items;
+    for(int i = 0; i < Items; ++i)
+        items.insert(itemKey(i), i);
+
+    QtFirebaseDatabaseRequest seed;
+    QSignalSpy completed(&seed, &QtFirebaseDatabaseRequest::completed);
+    seed.child(Root)->setValue(items);
+    QVERIFY(completed.wait(30000));
+    QVERIFY2(completed.first().first().toBool(), qPrintable(seed.errorMsg()));
+}
+
+void tst_DatabaseRequests::overlappingGets_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("paths");
+
+    // Gets of the same location share one download, these take that path too
+    QTest::newRow("10000 paths") << 10000 << Items;
+    QTest::newRow("100 paths") << 10000 << 100;
+    QTest::newRow("1 path") << 10000 << 1;
+}
+
+void tst_DatabaseRequests::overlappingGets()
+{
+    QFETCH(int, count);
+    QFETCH(int, paths);
+
+    QVector<QtFirebaseDatabaseRequest *> requests;
+    QVector<int> completions(count, 0);
+    QVector<int> failures(count, 0);
+    int done = 0;
+    // Owns the requests and their connections, also when a check fails
+    QObject context;
+
+    requests.reserve(count);
+    for(int i = 0; i < count; ++i) {
+        QtFirebaseDatabaseRequest *request = new QtFirebaseDatabaseRequest();
+        request->setParent(&context);
+        connect(request, &QtFirebaseDatabaseRequest::completed, &context, [&, i](bool success) {
+            completions[i]++;
+            if(!success)
+                failures[i]++;
+            done++;
+        });
+        requests.append(request);
+    }
+
+    // All issued before any of them can complete
+    for(int i = 0; i < count; ++i)
+        requests[i]->child(Root + QLatin1Char('/') + itemKey(i % paths))->exec();
+
+    QTRY_VERIFY_WITH_TIMEOUT(done >= count, 120000);
+    // Late duplicates would arrive with the next dispatch
+    QTest::qWait(1500);
+
+    for(int i = 0; i < count; ++i) {
+        QVERIFY2(completions[i] == 1, qPrintable(QStringLiteral("request %1 completed %2 times").arg(i).arg(completions[i])));
+        QVERIFY2(failures[i] == 0, qPrintable(requests[i]->errorMsg()));
+        QCOMPARE(requests[i]->snapshot()->value().toInt(), i % paths);
+    }
+}
+
+QTEST_MAIN(tst_DatabaseRequests)
+
+#include "tst_databaserequests.moc"
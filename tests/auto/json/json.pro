@@ -0,0 +1,7 @@
+TARGET = tst_json
+
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_json.cpp \
+    \
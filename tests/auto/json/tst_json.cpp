@@ -0,0 +1,73 @@
+#include "src/qtfirebasejson.h"
+
+#include "firebase/variant.h"
+
+#include <QtTest>
+
+#include <limits>
+
+/*
+ * Numbers read by QtFirebaseJson, integers have to stay exact over the whole int64 range
+ */
+class tst_Json : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void integers_data();
+    void integers();
+    void outOfRange_data();
+    void outOfRange();
+};
+
+void tst_Json::integers_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("zero") << QByteArray("0") << Q_INT64_C(0);
+    QTest::newRow("negative zero") << QByteArray("-0") << Q_INT64_C(0);
+    QTest::newRow("18 digits") << QByteArray("999999999999999999") << Q_INT64_C(999999999999999999);
+    QTest::newRow("19 digits") << QByteArray("1234567890123456789") << Q_INT64_C(1234567890123456789);
+    QTest::newRow("INT64_MAX") << QByteArray("9223372036854775807") << std::numeric_limits<qint64>::max();
+    QTest::newRow("INT64_MIN") << QByteArray("-9223372036854775808") << std::numeric_limits<qint64>::min();
+}
+
+void tst_Json::integers()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(qint64, expected);
+
+    firebase::Variant variant;
+    QString error;
+    QVERIFY2(QtFirebaseJson::fromJson(json, variant, &error), qPrintable(error));
+    QVERIFY(variant.is_int64());
+    QCOMPARE(static_cast<qint64>(variant.int64_value()), expected);
+    QCOMPARE(QtFirebaseJson::toJson(variant, QtFirebaseJson::Compact), json == "-0" ? QByteArray("0") : json);
+}
+
+void tst_Json::outOfRange_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("INT64_MAX + 1") << QByteArray("9223372036854775808") << 9223372036854775808.0;
+    QTest::newRow("INT64_MIN - 1") << QByteArray("-9223372036854775809") << -9223372036854775808.0;
+    QTest::newRow("20 digits") << QByteArray("12345678901234567890") << 12345678901234567890.0;
+}
+
+void tst_Json::outOfRange()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(double, expected);
+
+    firebase::Variant variant;
+    QString error;
+    QVERIFY2(QtFirebaseJson::fromJson(json, variant, &error), qPrintable(error));
+    QVERIFY(variant.is_double());
+    QCOMPARE(variant.double_value(), expected);
+}
+
+QTEST_MAIN(tst_Json)
+
+#include "tst_json.moc"
@@ -0,0 +1,8 @@
+TARGET = tst_bench_allocations
+
+QTFIREBASE_CONFIG += analytics remote_config
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_allocations.cpp \
+    \
@@ -0,0 +1,275 @@
+#include "src/qtfirebaseanalytics.h"
+#include "src/qtfirebaseremoteconfig.h"
+#include "src/qtfirebaseservice.h"
+#include "testapp.h"
+#include "testtrees.h"
+
+#include <QtTest>
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Heap allocations per operation, before and after the scratch arena
+ *
+ * Every malloc(), calloc() and realloc() of the process is counted, Qt containers
+ * and operator new included, by interposing them over glibc's. The "before" rows run
+ * reference copies of the implementations the arena replaced, the "after" rows the
+ * library. Results are reported as events (allocations) per call.
+ */
+
+namespace {
+    std::atomic<qint64> allocations(0);
+}
+
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+
+    void *malloc(size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *pointer, size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(pointer, size);
+    }
+}
+
+namespace analytics = ::firebase::analytics;
+namespace remote_config = ::firebase::remote_config;
+
+// Allocations of one call of f, after a first call that warms up caches
+template <typename Function>
+static qint64 countAllocations(Function f)
+{
+    f();
+    const qint64 start = allocations.load();
+    f();
+    return allocations.load() - start;
+}
+
+// fromQtVariant before the arena: a std::string per key and string, containers copied per level
+static firebase::Variant naiveFromQtVariant(const QVariant &v)
+{
+    switch(v.type())
+    {
+        case QVariant::Bool:
+            return firebase::Variant(v.toBool());
+        case QVariant::Int:
+            return firebase::Variant(static_cast<int64_t>(v.toInt()));
+        case QVariant::Double:
+            return firebase::Variant(v.toDouble());
+        case QVariant::String:{
+            std::string str(v.toString().toUtf8().constData());
+            return firebase::Variant(str);
+        }
+        case QVariant::Map:{
+            QVariantMap srcMap = v.toMap();
+            std::map<std::string, firebase::Variant> targetMap;
+            for(QVariantMap::const_iterator it = srcMap.begin(); it != srcMap.end(); ++it)
+                targetMap[it.key().toUtf8().constData()] = naiveFromQtVariant(it.value());
+            return firebase::Variant(targetMap);
+        }
+        case QVariant::List:{
+            QVariantList srcLst = v.toList();
+            std::vector<firebase::Variant> targetLst;
+            for(QVariantList::const_iterator it = srcLst.begin(); it != srcLst.end(); ++it)
+                targetLst.push_back(naiveFromQtVariant(*it));
+            return firebase::Variant(targetLst);
+        }
+        default:
+            return firebase::Variant::Null();
+    }
+}
+
+// logEvent() before the arena, without its debug output
+static void naiveLogEvent(const QString &name, const QVariantMap &bundle)
+{
+    analytics::Parameter *parameters = new analytics::Parameter[bundle.size()];
+
+    QByteArrayList keys;
+    QByteArrayList strings;
+
+    int index = 0;
+    for(QVariantMap::const_iterator it = bundle.begin(); it != bundle.end(); ++it, ++index) {
+        keys.append(it.key().toUtf8());
+        const QVariant variant = it.value();
+
+        if(variant.type() == QVariant::Int) {
+            parameters[index] = analytics::Parameter(keys.at(index).constData(), variant.toInt());
+        } else if(variant.type() == QVariant::Double) {
+            parameters[index] = analytics::Parameter(keys.at(index).constData(), variant.toDouble());
+        } else if(variant.type() == QVariant::String) {
+            strings.append(variant.toString().toUtf8());
+            parameters[index] = analytics::Parameter(keys.at(index).constData(), strings.last().constData());
+        } else {
+            parameters[index] = analytics::Parameter("", "");
+        }
+    }
+
+    analytics::LogEvent(name.toUtf8().constData(), parameters, static_cast<size_t>(bundle.size()));
+    delete[] parameters;
+}
+
+// RemoteConfig defaults before the arena. NOTE strings are kept alive here, the original
+// passed pointers into temporaries
+static void naiveSetDefaults(const QVariantMap &parameters)
+{
+    QVariantMap filteredMap;
+    for(QVariantMap::const_iterator it = parameters.begin(); it != parameters.end(); ++it) {
+        const QVariant &value = it.value();
+        if(value.type() == QVariant::Bool || value.type() == QVariant::LongLong || value.type() == QVariant::Int ||
+                value.type() == QVariant::Double || value.type() == QVariant::String)
+            filteredMap[it.key()] = value;
+    }
+
+    std::unique_ptr<remote_config::ConfigKeyValueVariant[]> defaults(new remote_config::ConfigKeyValueVariant[filteredMap.size()]);
+
+    QByteArrayList keys;
+    QByteArrayList strings;
+    size_t index = 0;
+    for(QVariantMap::const_iterator it = filteredMap.begin(); it != filteredMap.end(); ++it, ++index) {
+        keys.append(it.key().toUtf8());
+        const char *key = keys.last().constData();
+        const QVariant &value = it.value();
+
+        if(value.type() == QVariant::Bool) {
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, value.toBool()};
+        } else if(value.type() == QVariant::LongLong) {
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, static_cast<int64_t>(value.toLongLong())};
+        } else if(value.type() == QVariant::Int) {
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, value.toInt()};
+        } else if(value.type() == QVariant::Double) {
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, value.toDouble()};
+        } else {
+            strings.append(value.toString().toUtf8());
+            defaults[index] = remote_config::ConfigKeyValueVariant{key, strings.last().constData()};
+        }
+    }
+
+    remote_config::SetDefaults(defaults.get(), static_cast<size_t>(filteredMap.size()));
+}
+
+class tst_BenchAllocations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void fromQtVariant_data();
+    void fromQtVariant();
+    void logEvent_data();
+    void logEvent();
+    void setDefaults_data();
+    void setDefaults();
+};
+
+void tst_BenchAllocations::initTestCase()
+{
+    QVERIFY(TestApp::init());
+    QTRY_VERIFY(qFirebaseAnalytics->ready());
+    QTRY_VERIFY(qFirebaseRemoteConfig->ready());
+}
+
+void tst_BenchAllocations::fromQtVariant_data()
+{
+    QTest::addColumn<bool>("before");
+    QTest::addColumn<QVariant>("tree");
+
+    const QVariant flat = TestTrees::flatMap(1000);
+    const QVariant nested = TestTrees::nested(100);
+    const QVariant strings = TestTrees::largeStrings(100, 1024);
+
+    QTest::newRow("before/flat-1000") << true << flat;
+    QTest::newRow("after/flat-1000") << false << flat;
+    QTest::newRow("before/nested-100") << true << nested;
+    QTest::newRow("after/nested-100") << false << nested;
+    QTest::newRow("before/strings-100x1k") << true << strings;
+    QTest::newRow("after/strings-100x1k") << false << strings;
+}
+
+void tst_BenchAllocations::fromQtVariant()
+{
+    QFETCH(bool, before);
+    QFETCH(QVariant, tree);
+
+    const qint64 count = countAllocations([&]() {
+        firebase::Variant converted = before ? naiveFromQtVariant(tree) : QtFirebaseService::fromQtVariant(tree);
+        Q_UNUSED(converted)
+    });
+    QTest::setBenchmarkResult(count, QTest::Events);
+}
+
+void tst_BenchAllocations::logEvent_data()
+{
+    QTest::addColumn<bool>("before");
+    QTest::addColumn<int>("parameters");
+
+    QTest::newRow("before/10") << true << 10;
+    QTest::newRow("after/10") << false << 10;
+    QTest::newRow("before/25") << true << 25;
+    QTest::newRow("after/25") << false << 25;
+}
+
+void tst_BenchAllocations::logEvent()
+{
+    QFETCH(bool, before);
+    QFETCH(int, parameters);
+    const QVariantMap bundle = TestTrees::flatMap(parameters);
+    const QString name = QStringLiteral("level_complete");
+
+    const qint64 count = countAllocations([&]() {
+        if(before)
+            naiveLogEvent(name, bundle);
+        else
+            qFirebaseAnalytics->logEvent(name, bundle);
+    });
+    QTest::setBenchmarkResult(count, QTest::Events);
+}
+
+void tst_BenchAllocations::setDefaults_data()
+{
+    QTest::addColumn<bool>("before");
+    QTest::addColumn<int>("parameters");
+
+    QTest::newRow("before/10") << true << 10;
+    QTest::newRow("after/10") << false << 10;
+    QTest::newRow("before/100") << true << 100;
+    QTest::newRow("after/100") << false << 100;
+}
+
+// NOTE both include what SetDefaults() allocates itself
+void tst_BenchAllocations::setDefaults()
+{
+    QFETCH(bool, before);
+    QFETCH(int, parameters);
+    const QVariantMap defaults = TestTrees::flatMap(parameters);
+    qFirebaseRemoteConfig->setParameters(defaults);
+
+    const qint64 count = countAllocations([&]() {
+        if(before)
+            naiveSetDefaults(defaults);
+        else
+            qFirebaseRemoteConfig->applyDefaults();
+    });
+    QTest::setBenchmarkResult(count, QTest::Events);
+}
+
+QTEST_MAIN(tst_BenchAllocations)
+
+#include "tst_bench_allocations.moc"
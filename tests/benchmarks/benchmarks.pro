@@ -0,0 +1,14 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    allocations \
+    conversion \
+    dispatch \
+    latency \
+    logging \
+    logging_runtime \
+    modules \
+    snapshot \
+
+benchmark.CONFIG = recursive
+QMAKE_EXTRA_TARGETS += benchmark
@@ -0,0 +1,71 @@
+#include "src/qtfirebaseservice.h"
+#include "testtrees.h"
+
+#include <QtTest>
+
+/*
+ * QVariant <-> firebase::Variant conversion of the shapes apps typically send and receive
+ */
+class tst_BenchConversion : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromQtVariant_data();
+    void fromQtVariant();
+    void fromFirebaseVariant_data();
+    void fromFirebaseVariant();
+};
+
+static void addShapes()
+{
+    QTest::addColumn<QVariant>("tree");
+
+    QTest::newRow("flat-10") << QVariant(TestTrees::flatMap(10));
+    QTest::newRow("flat-10000") << QVariant(TestTrees::flatMap(10000));
+    QTest::newRow("records-100") << QVariant(TestTrees::records(100));
+    QTest::newRow("records-10000") << QVariant(TestTrees::records(10000));
+    QTest::newRow("nested-100") << QVariant(TestTrees::nested(100));
+    QTest::newRow("nested-1000") << QVariant(TestTrees::nested(1000));
+    QTest::newRow("wide-100000") << QVariant(TestTrees::flatMap(100000));
+    QTest::newRow("deep-100") << QVariant(TestTrees::deep(100));
+    QTest::newRow("deep-1000") << QVariant(TestTrees::deep(1000));
+    // About 5 MB of text
+    QTest::newRow("strings-10x512k") << QVariant(TestTrees::largeStrings(10, 512 * 1024));
+    QTest::newRow("strings-5000x1k") << QVariant(TestTrees::largeStrings(5000, 1024));
+}
+
+void tst_BenchConversion::fromQtVariant_data()
+{
+    addShapes();
+}
+
+void tst_BenchConversion::fromQtVariant()
+{
+    QFETCH(QVariant, tree);
+
+    QBENCHMARK {
+        firebase::Variant converted = QtFirebaseService::fromQtVariant(tree);
+        Q_UNUSED(converted)
+    }
+}
+
+void tst_BenchConversion::fromFirebaseVariant_data()
+{
+    addShapes();
+}
+
+void tst_BenchConversion::fromFirebaseVariant()
+{
+    QFETCH(QVariant, tree);
+    const firebase::Variant source = QtFirebaseService::fromQtVariant(tree);
+
+    QBENCHMARK {
+        QVariant converted = QtFirebaseService::fromFirebaseVariant(source);
+        Q_UNUSED(converted)
+    }
+}
+
+QTEST_MAIN(tst_BenchConversion)
+
+#include "tst_bench_conversion.moc"
@@ -0,0 +1,7 @@
+TARGET = tst_bench_dispatch
+
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_dispatch.cpp \
+    \
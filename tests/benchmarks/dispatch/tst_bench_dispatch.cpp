@@ -0,0 +1,99 @@
+#include "src/qtfirebase.h"
+#include "fakefutureapi.h"
+#include "testapp.h"
+
+#include <QtTest>
+
+/*
+ * Future bookkeeping of QtFirebase with fake SDK futures
+ */
+class tst_BenchDispatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void processEvents_data();
+    void processEvents();
+    void dispatch_data();
+    void dispatch();
+
+private:
+    FakeFutureApi m_api;
+};
+
+static void addCounts()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_BenchDispatch::initTestCase()
+{
+    QVERIFY(TestApp::init());
+}
+
+void tst_BenchDispatch::processEvents_data()
+{
+    addCounts();
+}
+
+// One pass over count pending futures, none of them done
+void tst_BenchDispatch::processEvents()
+{
+    QFETCH(int, count);
+
+    QVector<QtFirebaseFutureHandle> handles;
+    handles.reserve(count);
+    for(int i = 0; i < count; ++i)
+        handles.append(qFirebase->addFuture(m_api.create(), [](QtFirebaseFutureHandle, const firebase::FutureBase &) {}));
+
+    QBENCHMARK {
+        qFirebase->processEvents();
+    }
+
+    for(QtFirebaseFutureHandle handle : handles)
+        QVERIFY(qFirebase->removeFuture(handle));
+    QCOMPARE(m_api.pending(), 0);
+}
+
+void tst_BenchDispatch::dispatch_data()
+{
+    addCounts();
+}
+
+// count futures added, completed by the SDK and delivered through the queued completion path
+void tst_BenchDispatch::dispatch()
+{
+    QFETCH(int, count);
+
+    QVector<firebase::FutureBase> futures;
+    futures.reserve(count);
+    int delivered = 0;
+
+    QBENCHMARK {
+        delivered = 0;
+        for(int i = 0; i < count; ++i) {
+            futures.append(m_api.create());
+            qFirebase->addFuture(futures.last(), [&delivered](QtFirebaseFutureHandle, const firebase::FutureBase &) {
+                delivered++;
+            });
+        }
+        for(const firebase::FutureBase &future : futures)
+            m_api.complete(future);
+        QCoreApplication::sendPostedEvents(qFirebase, QEvent::MetaCall);
+        futures.clear();
+    }
+
+    QCOMPARE(delivered, count);
+    QCOMPARE(m_api.pending(), 0);
+}
+
+QTEST_MAIN(tst_BenchDispatch)
+
+#include "tst_bench_dispatch.moc"
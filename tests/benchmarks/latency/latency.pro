@@ -0,0 +1,7 @@
+TARGET = tst_bench_latency
+
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_latency.cpp \
+    \
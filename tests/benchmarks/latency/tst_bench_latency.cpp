@@ -0,0 +1,117 @@
+#include "src/qtfirebase.h"
+#include "fakefutureapi.h"
+#include "testapp.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Delay from the SDK completing a future to QtFirebase::futureEvent
+ *
+ * Futures are completed on a worker thread, like the SDK does. With callbacks the
+ * result is dispatched through OnCompletion and a queued processEvents(). Without
+ * them only the 1 s watch timer picks it up, which is how every future was delivered
+ * before the completion path existed.
+ */
+class tst_BenchLatency : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void futureEvent_data();
+    void futureEvent();
+
+private:
+    bool sample(bool callbacks, QVector<qint64> &latencies);
+
+    FakeFutureApi m_api;
+    QHash<bool, QVector<qint64> > m_latencies;
+};
+
+void tst_BenchLatency::initTestCase()
+{
+    QVERIFY(TestApp::init());
+}
+
+// Latencies (ns) of a series of futures, each completed at a different point of the watch timer period
+bool tst_BenchLatency::sample(bool callbacks, QVector<qint64> &latencies)
+{
+    // NOTE poll-only samples take up to a second each
+    const int count = callbacks ? 1000 : 30;
+    const int spread = callbacks ? 5 : 1000;
+
+    m_api.setCallbacksEnabled(callbacks);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    for(int i = 0; i < count; ++i) {
+        const QString eventId = QStringLiteral("latency.%1").arg(i);
+        firebase::FutureBase future = m_api.create();
+
+        qint64 delivered = -1;
+        QMetaObject::Connection connection = connect(qFirebase, &QtFirebase::futureEvent, this,
+                                                     [&](const QString &id, firebase::FutureBase) {
+            if(id == eventId)
+                delivered = clock.nsecsElapsed();
+        });
+        qFirebase->addFuture(eventId, future);
+
+        qint64 completed = 0;
+        const unsigned long delay = static_cast<unsigned long>((i * 7919) % spread);
+        QThread *completer = QThread::create([&]() {
+            QThread::msleep(delay);
+            completed = clock.nsecsElapsed();
+            m_api.complete(future);
+        });
+        completer->start();
+
+        const bool ok = QTest::qWaitFor([&delivered]() { return delivered >= 0; }, 5000);
+        completer->wait();
+        delete completer;
+        disconnect(connection);
+        if(!ok)
+            return false;
+
+        latencies.append(delivered - completed);
+    }
+
+    m_api.setCallbacksEnabled(true);
+    std::sort(latencies.begin(), latencies.end());
+    return true;
+}
+
+void tst_BenchLatency::futureEvent_data()
+{
+    QTest::addColumn<bool>("callbacks");
+    QTest::addColumn<double>("percentile");
+
+    QTest::newRow("event-p50") << true << 0.50;
+    QTest::newRow("event-p99") << true << 0.99;
+    QTest::newRow("poll-p50") << false << 0.50;
+    QTest::newRow("poll-p99") << false << 0.99;
+}
+
+void tst_BenchLatency::futureEvent()
+{
+    QFETCH(bool, callbacks);
+    QFETCH(double, percentile);
+
+    // Both percentiles of a mode come from the same series
+    if(!m_latencies.contains(callbacks)) {
+        QVector<qint64> latencies;
+        QVERIFY2(sample(callbacks, latencies), "future was not delivered");
+        m_latencies.insert(callbacks, latencies);
+    }
+
+    const QVector<qint64> &latencies = m_latencies[callbacks];
+    const int rank = qBound(0, static_cast<int>(std::ceil(percentile * latencies.size())) - 1, latencies.size() - 1);
+    QTest::setBenchmarkResult(latencies.at(rank) / 1e6, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_BenchLatency)
+
+#include "tst_bench_latency.moc"
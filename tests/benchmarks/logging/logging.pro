@@ -0,0 +1,9 @@
+TARGET = tst_bench_logging
+
+# Debug statements compiled out, logging_runtime builds the same with them only disabled
+QTFIREBASE_CONFIG += analytics nodebuglog
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_logging.cpp \
+    \
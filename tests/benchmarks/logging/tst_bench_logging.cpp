@@ -0,0 +1,101 @@
+#include "src/qtfirebase.h"
+#include "src/qtfirebaseanalytics.h"
+#include "fakefutureapi.h"
+#include "testapp.h"
+#include "testtrees.h"
+
+#include <QtTest>
+
+/*
+ * Throughput of the hot paths that log, with debug logging off
+ *
+ * Built twice: tst_bench_logging with QTFIREBASE_NO_DEBUG_LOG (nothing is left of
+ * the debug statements) and tst_bench_logging_runtime, where every statement still
+ * checks its disabled category.
+ */
+class tst_BenchLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void logEvent_data();
+    void logEvent();
+    void processEvents_data();
+    void processEvents();
+
+private:
+    FakeFutureApi m_api;
+};
+
+void tst_BenchLogging::initTestCase()
+{
+#if !defined(QTFIREBASE_NO_DEBUG_LOG)
+    // NOTE QT_LOGGING_RULES from the environment still wins, keep it unset when measuring
+    QLoggingCategory::setFilterRules(QStringLiteral("qtfirebase*.debug=false"));
+#endif
+
+    QVERIFY(TestApp::init());
+    QTRY_VERIFY(qFirebaseAnalytics->ready());
+}
+
+void tst_BenchLogging::logEvent_data()
+{
+    QTest::addColumn<int>("parameters");
+
+    QTest::newRow("0") << 0;
+    QTest::newRow("10") << 10;
+    QTest::newRow("25") << 25;
+}
+
+void tst_BenchLogging::logEvent()
+{
+    QFETCH(int, parameters);
+    const QVariantMap bundle = TestTrees::flatMap(parameters);
+    const QString name = QStringLiteral("level_complete");
+
+    QBENCHMARK {
+        qFirebaseAnalytics->logEvent(name, bundle);
+    }
+}
+
+void tst_BenchLogging::processEvents_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("1000") << 1000;
+}
+
+// count futures added, completed and dispatched by one processEvents()
+void tst_BenchLogging::processEvents()
+{
+    QFETCH(int, count);
+
+    QVector<firebase::FutureBase> futures;
+    futures.reserve(count);
+    int delivered = 0;
+
+    // Without completion callbacks nothing is queued, the dispatch is the direct call below
+    m_api.setCallbacksEnabled(false);
+    QBENCHMARK {
+        delivered = 0;
+        for(int i = 0; i < count; ++i) {
+            futures.append(m_api.create());
+            qFirebase->addFuture(futures.last(), [&delivered](QtFirebaseFutureHandle, const firebase::FutureBase &) {
+                delivered++;
+            });
+        }
+        for(const firebase::FutureBase &future : futures)
+            m_api.complete(future);
+        qFirebase->processEvents();
+        futures.clear();
+    }
+    m_api.setCallbacksEnabled(true);
+
+    QCOMPARE(delivered, count);
+}
+
+QTEST_MAIN(tst_BenchLogging)
+
+#include "tst_bench_logging.moc"
@@ -0,0 +1,9 @@
+TARGET = tst_bench_logging_runtime
+
+# Same as logging, with the debug statements compiled in and their categories disabled
+QTFIREBASE_CONFIG += analytics
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    ../logging/tst_bench_logging.cpp \
+    \
@@ -0,0 +1,8 @@
+TARGET = tst_bench_modules
+
+QTFIREBASE_CONFIG += analytics remote_config
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_modules.cpp \
+    \
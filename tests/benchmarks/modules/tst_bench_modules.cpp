@@ -0,0 +1,75 @@
+#include "src/qtfirebaseanalytics.h"
+#include "src/qtfirebaseremoteconfig.h"
+#include "testapp.h"
+#include "testtrees.h"
+
+#include <QtTest>
+
+/*
+ * Request building of the modules, the SDK calls themselves are local on desktop
+ */
+class tst_BenchModules : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void logEvent_data();
+    void logEvent();
+    void applyDefaults_data();
+    void applyDefaults();
+};
+
+void tst_BenchModules::initTestCase()
+{
+    // NOTE the App has to exist before the modules, they create it with the current options otherwise
+    QVERIFY(TestApp::init());
+    QTRY_VERIFY(qFirebaseAnalytics->ready());
+    QTRY_VERIFY(qFirebaseRemoteConfig->ready());
+}
+
+void tst_BenchModules::logEvent_data()
+{
+    QTest::addColumn<int>("parameters");
+
+    // Analytics takes at most 25 parameters per event
+    QTest::newRow("0") << 0;
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("25") << 25;
+}
+
+void tst_BenchModules::logEvent()
+{
+    QFETCH(int, parameters);
+    const QVariantMap bundle = TestTrees::flatMap(parameters);
+    const QString name = QStringLiteral("level_complete");
+
+    QBENCHMARK {
+        qFirebaseAnalytics->logEvent(name, bundle);
+    }
+}
+
+void tst_BenchModules::applyDefaults_data()
+{
+    QTest::addColumn<int>("parameters");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void tst_BenchModules::applyDefaults()
+{
+    QFETCH(int, parameters);
+    qFirebaseRemoteConfig->setParameters(TestTrees::flatMap(parameters));
+
+    QBENCHMARK {
+        qFirebaseRemoteConfig->applyDefaults();
+    }
+}
+
+QTEST_MAIN(tst_BenchModules)
+
+#include "tst_bench_modules.moc"
@@ -0,0 +1,8 @@
+TARGET = tst_bench_snapshot
+
+QTFIREBASE_CONFIG += database
+include(../../qtfirebasetest.pri)
+
+SOURCES += \
+    tst_bench_snapshot.cpp \
+    \
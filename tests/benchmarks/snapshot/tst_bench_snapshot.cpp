@@ -0,0 +1,71 @@
+#include "src/qtfirebasedatabase.h"
+#include "testtrees.h"
+
+#include <QtTest>
+
+/*
+ * Serialization of database snapshots to JSON
+ */
+class tst_BenchSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void jsonString_data();
+    void jsonString();
+    void compactJsonString_data();
+    void compactJsonString();
+};
+
+static void addShapes()
+{
+    QTest::addColumn<QVariant>("tree");
+
+    QTest::newRow("flat-10") << QVariant(TestTrees::flatMap(10));
+    QTest::newRow("flat-10000") << QVariant(TestTrees::flatMap(10000));
+    QTest::newRow("records-10000") << QVariant(TestTrees::records(10000));
+    QTest::newRow("nested-1000") << QVariant(TestTrees::nested(1000));
+}
+
+static QtFirebaseSnapshotData snapshotOf(const QVariant &tree)
+{
+    return QtFirebaseSnapshotData(QStringLiteral("root"), QtFirebaseSnapshotNode::create(QtFirebaseService::fromQtVariant(tree)));
+}
+
+void tst_BenchSnapshot::jsonString_data()
+{
+    addShapes();
+}
+
+void tst_BenchSnapshot::jsonString()
+{
+    QFETCH(QVariant, tree);
+    QtFirebaseDataSnapshot snapshot(snapshotOf(tree));
+    QVERIFY(snapshot.exists());
+
+    QBENCHMARK {
+        QByteArray json = snapshot.jsonString();
+        Q_UNUSED(json)
+    }
+}
+
+void tst_BenchSnapshot::compactJsonString_data()
+{
+    addShapes();
+}
+
+void tst_BenchSnapshot::compactJsonString()
+{
+    QFETCH(QVariant, tree);
+    QtFirebaseDataSnapshot snapshot(snapshotOf(tree));
+    QVERIFY(snapshot.exists());
+
+    QBENCHMARK {
+        QByteArray json = snapshot.compactJsonString();
+        Q_UNUSED(json)
+    }
+}
+
+QTEST_MAIN(tst_BenchSnapshot)
+
+#include "tst_bench_snapshot.moc"
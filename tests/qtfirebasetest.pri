@@ -0,0 +1,39 @@
+# Shared setup of the QtFirebase tests and benchmarks
+#
+# They compile the library sources in and link the desktop Firebase C++ SDK,
+# set the modules they need on QTFIREBASE_CONFIG before including this file.
+# NOTE the stub/ build only mirrors the QML types, it has no firebase:: API to measure.
+#
+#   qmake tests/tests.pro QTFIREBASE_SDK_PATH=/path/to/firebase_cpp_sdk
+#   make && make check
+#
+# 'make benchmark' runs every target and writes its results as QtTest XML next
+# to the binary (<target>.xml), for tracking regressions between SDK upgrades.
+
+TEMPLATE = app
+
+QT += testlib qml quick
+
+CONFIG += testcase c++11 console
+CONFIG -= app_bundle
+
+QTFIREBASE_CONFIG += noautoregister
+include($$PWD/../qtfirebase.pri)
+
+INCLUDEPATH += $$PWD/shared
+
+HEADERS += \
+    $$PWD/shared/fakefutureapi.h \
+    $$PWD/shared/testapp.h \
+    $$PWD/shared/testtrees.h \
+    \
+
+SOURCES += \
+    $$PWD/shared/fakefutureapi.cpp \
+    $$PWD/shared/testapp.cpp \
+    $$PWD/shared/testtrees.cpp \
+    \
+
+benchmark.depends = $(TARGET)
+benchmark.commands = ./$(TARGET) -o $${TARGET}.xml,xml -o -,txt
+QMAKE_EXTRA_TARGETS += benchmark
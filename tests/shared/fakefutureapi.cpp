@@ -0,0 +1,231 @@
+#include "fakefutureapi.h"
+
+#include <QMutexLocker>
+
+FakeFutureApi::FakeFutureApi():
+    m_nextId(1),
+    m_callbacks(true)
+{
+}
+
+FakeFutureApi::~FakeFutureApi()
+{
+    for(State &state : m_states)
+        clearCallback(state);
+}
+
+firebase::FutureBase FakeFutureApi::create()
+{
+    firebase::FutureHandleId id;
+    {
+        QMutexLocker locker(&m_mutex);
+        id = m_nextId++;
+        m_states.insert(id, State());
+    }
+    // NOTE the FutureBase takes the first reference
+    return firebase::FutureBase(this, firebase::FutureHandle(id));
+}
+
+void FakeFutureApi::complete(const firebase::FutureBase &future, int error)
+{
+    State state;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_states.find(future.GetHandle().id());
+        if(it == m_states.end() || it->done)
+            return;
+
+        it->done = true;
+        it->error = error;
+        if(!m_callbacks)
+            return;
+
+        // Completion callbacks run once, outside the lock (they may query the future)
+        state = *it;
+        it->callback = nullptr;
+        it->userData = nullptr;
+        it->userDataDelete = nullptr;
+        it->lambda = nullptr;
+    }
+
+    if(state.callback)
+        state.callback(future, state.userData);
+    if(state.lambda)
+        state.lambda(future);
+    clearCallback(state);
+}
+
+void FakeFutureApi::setCallbacksEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_callbacks = enabled;
+}
+
+bool FakeFutureApi::callbacksEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_callbacks;
+}
+
+int FakeFutureApi::pending() const
+{
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+    for(const State &state : m_states) {
+        if(!state.done)
+            count++;
+    }
+    return count;
+}
+
+void FakeFutureApi::ReferenceFuture(const firebase::FutureHandle &handle)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_states.find(handle.id());
+    if(it != m_states.end())
+        it->references++;
+}
+
+void FakeFutureApi::ReleaseFuture(const firebase::FutureHandle &handle)
+{
+    State state;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_states.find(handle.id());
+        if(it == m_states.end() || --it->references > 0)
+            return;
+
+        state = *it;
+        m_states.erase(it);
+    }
+    clearCallback(state);
+}
+
+firebase::FutureStatus FakeFutureApi::GetFutureStatus(const firebase::FutureHandle &handle) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_states.constFind(handle.id());
+    if(it == m_states.constEnd())
+        return firebase::kFutureStatusInvalid;
+    return it->done ? firebase::kFutureStatusComplete : firebase::kFutureStatusPending;
+}
+
+int FakeFutureApi::GetFutureError(const firebase::FutureHandle &handle) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_states.constFind(handle.id());
+    return it == m_states.constEnd() ? -1 : it->error;
+}
+
+const char *FakeFutureApi::GetFutureErrorMessage(const firebase::FutureHandle &handle) const
+{
+    return GetFutureError(handle) == 0 ? "" : "fake error";
+}
+
+const void *FakeFutureApi::GetFutureResult(const firebase::FutureHandle &handle) const
+{
+    Q_UNUSED(handle)
+    return nullptr;
+}
+
+firebase::detail::CompletionCallbackHandle FakeFutureApi::AddCompletionCallback(const firebase::FutureHandle &handle,
+                                                                                 firebase::FutureBase::CompletionCallback callback,
+                                                                                 void *userData, void (*userDataDelete)(void *),
+                                                                                 bool singleCompletion)
+{
+    Q_UNUSED(singleCompletion)
+
+    bool callNow = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_states.find(handle.id());
+        if(it == m_states.end())
+            return firebase::detail::CompletionCallbackHandle();
+
+        // Like the SDK, callbacks added to a completed future are called right away
+        callNow = it->done && m_callbacks;
+        if(!callNow) {
+            clearCallback(*it);
+            it->callback = callback;
+            it->userData = userData;
+            it->userDataDelete = userDataDelete;
+        }
+    }
+
+    if(callNow) {
+        callback(firebase::FutureBase(this, handle), userData);
+        if(userDataDelete)
+            userDataDelete(userData);
+    }
+    return firebase::detail::CompletionCallbackHandle();
+}
+
+void FakeFutureApi::RemoveCompletionCallback(const firebase::FutureHandle &handle,
+                                             firebase::detail::CompletionCallbackHandle callbackHandle)
+{
+    Q_UNUSED(callbackHandle)
+
+    State state;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_states.find(handle.id());
+        if(it == m_states.end())
+            return;
+
+        state.userData = it->userData;
+        state.userDataDelete = it->userDataDelete;
+        it->callback = nullptr;
+        it->userData = nullptr;
+        it->userDataDelete = nullptr;
+        it->lambda = nullptr;
+    }
+    clearCallback(state);
+}
+
+#if defined(FIREBASE_USE_STD_FUNCTION)
+firebase::detail::CompletionCallbackHandle FakeFutureApi::AddCompletionCallbackLambda(const firebase::FutureHandle &handle,
+                                                                                       std::function<void(const firebase::FutureBase &)> callback,
+                                                                                       bool singleCompletion)
+{
+    Q_UNUSED(singleCompletion)
+
+    bool callNow = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_states.find(handle.id());
+        if(it == m_states.end())
+            return firebase::detail::CompletionCallbackHandle();
+
+        callNow = it->done && m_callbacks;
+        if(!callNow) {
+            clearCallback(*it);
+            it->lambda = callback;
+        }
+    }
+
+    if(callNow)
+        callback(firebase::FutureBase(this, handle));
+    return firebase::detail::CompletionCallbackHandle();
+}
+#endif
+
+void FakeFutureApi::RegisterFutureForCleanup(firebase::FutureBase *future)
+{
+    // NOTE nothing to invalidate, the api outlives its futures
+    Q_UNUSED(future)
+}
+
+void FakeFutureApi::UnregisterFutureForCleanup(firebase::FutureBase *future)
+{
+    Q_UNUSED(future)
+}
+
+void FakeFutureApi::clearCallback(State &state)
+{
+    if(state.userDataDelete)
+        state.userDataDelete(state.userData);
+    state.callback = nullptr;
+    state.userData = nullptr;
+    state.userDataDelete = nullptr;
+    state.lambda = nullptr;
+}
@@ -0,0 +1,86 @@
+#ifndef FAKE_FUTURE_API_H
+#define FAKE_FUTURE_API_H
+
+#include "firebase/future.h"
+
+#include <QHash>
+#include <QMutex>
+
+#include <functional>
+
+/*
+ * Stand-in for the future backend of the Firebase SDK
+ *
+ * Hands out real firebase::FutureBase objects whose completion is driven by the
+ * test instead of a server, by implementing firebase::detail::FutureApiInterface
+ * (firebase/internal/future_impl.h). Like the SDK, complete() runs the completion
+ * callback on the calling thread, so futures can be completed from worker threads.
+ *
+ * Usage:
+ *   FakeFutureApi api;
+ *   firebase::FutureBase future = api.create();
+ *   qFirebase->addFuture(future, callback);
+ *   api.complete(future);
+ *
+ * The api must outlive every future it created.
+ */
+class FakeFutureApi : public firebase::detail::FutureApiInterface
+{
+public:
+    FakeFutureApi();
+    ~FakeFutureApi() override;
+
+    firebase::FutureBase create();
+    // Marks future done with error (0 is success) and calls its completion callback
+    void complete(const firebase::FutureBase &future, int error = 0);
+
+    // Disabled, completion callbacks are accepted but never called,
+    // like futures of a SDK that does not report completion
+    void setCallbacksEnabled(bool enabled);
+    bool callbacksEnabled() const;
+
+    // Futures that are referenced and not completed yet
+    int pending() const;
+
+    void ReferenceFuture(const firebase::FutureHandle &handle) override;
+    void ReleaseFuture(const firebase::FutureHandle &handle) override;
+    firebase::FutureStatus GetFutureStatus(const firebase::FutureHandle &handle) const override;
+    int GetFutureError(const firebase::FutureHandle &handle) const override;
+    const char *GetFutureErrorMessage(const firebase::FutureHandle &handle) const override;
+    const void *GetFutureResult(const firebase::FutureHandle &handle) const override;
+    firebase::detail::CompletionCallbackHandle AddCompletionCallback(const firebase::FutureHandle &handle,
+                                                                     firebase::FutureBase::CompletionCallback callback,
+                                                                     void *userData, void (*userDataDelete)(void *),
+                                                                     bool singleCompletion) override;
+    void RemoveCompletionCallback(const firebase::FutureHandle &handle,
+                                  firebase::detail::CompletionCallbackHandle callbackHandle) override;
+#if defined(FIREBASE_USE_STD_FUNCTION)
+    firebase::detail::CompletionCallbackHandle AddCompletionCallbackLambda(const firebase::FutureHandle &handle,
+                                                                           std::function<void(const firebase::FutureBase &)> callback,
+                                                                           bool singleCompletion) override;
+#endif
+    void RegisterFutureForCleanup(firebase::FutureBase *future) override;
+    void UnregisterFutureForCleanup(firebase::FutureBase *future) override;
+
+private:
+    // NOTE one callback per future, the SDK's OnCompletion() slot replaces the previous one as well
+    struct State
+    {
+        int references = 0;
+        bool done = false;
+        int error = 0;
+        firebase::FutureBase::CompletionCallback callback = nullptr;
+        void *userData = nullptr;
+        void (*userDataDelete)(void *) = nullptr;
+        std::function<void(const firebase::FutureBase &)> lambda;
+    };
+
+    static void clearCallback(State &state);
+
+    mutable QMutex m_mutex;
+    QHash<firebase::FutureHandleId, State> m_states;
+    firebase::FutureHandleId m_nextId;
+    bool m_callbacks;
+};
+
+#endif // FAKE_FUTURE_API_H
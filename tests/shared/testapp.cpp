@@ -0,0 +1,24 @@
+#include "testapp.h"
+
+#include "src/qtfirebase.h"
+
+#include <QtTest>
+
+namespace TestApp {
+
+    bool init(const QString &databaseUrl, int timeout)
+    {
+        // NOTE nothing here talks to a server, the desktop SDK only checks the options are set
+        firebase::AppOptions options;
+        options.set_app_id("1:000000000000:android:0000000000000000");
+        options.set_api_key("qtfirebase-test-api-key");
+        options.set_project_id("qtfirebase-test");
+        if(!databaseUrl.isEmpty())
+            options.set_database_url(databaseUrl.toUtf8().constData());
+
+        // Set before the first event loop iteration, which is when the App is created
+        qFirebase->setOptions(options);
+        return QTest::qWaitFor([]() { return qFirebase->ready(); }, timeout);
+    }
+
+}
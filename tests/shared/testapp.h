@@ -0,0 +1,13 @@
+#ifndef TEST_APP_H
+#define TEST_APP_H
+
+#include <QString>
+
+namespace TestApp {
+    // Creates the QtFirebase singleton with options of a made up project (databaseUrl
+    // empty keeps the SDK default) and spins the event loop until the App is ready.
+    // Returns false on timeout
+    bool init(const QString &databaseUrl = QString(), int timeout = 10000);
+}
+
+#endif // TEST_APP_H
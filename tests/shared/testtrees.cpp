@@ -0,0 +1,84 @@
+#include "testtrees.h"
+
+namespace TestTrees {
+
+    QVariantMap flatMap(int count)
+    {
+        QVariantMap map;
+        for(int i = 0; i < count; ++i) {
+            const QString key = QStringLiteral("key%1").arg(i, 6, 10, QLatin1Char('0'));
+            switch(i % 4) {
+            case 0: map.insert(key, i); break;
+            case 1: map.insert(key, i * 0.5); break;
+            case 2: map.insert(key, (i % 8) == 2); break;
+            default: map.insert(key, QStringLiteral("value %1").arg(i)); break;
+            }
+        }
+        return map;
+    }
+
+    QVariantList records(int count)
+    {
+        QVariantList list;
+        list.reserve(count);
+        for(int i = 0; i < count; ++i) {
+            QVariantMap record;
+            record.insert(QStringLiteral("id"), i);
+            record.insert(QStringLiteral("name"), QStringLiteral("player %1").arg(i));
+            record.insert(QStringLiteral("score"), i * 1.25);
+            record.insert(QStringLiteral("active"), i % 2 == 0);
+            list.append(record);
+        }
+        return list;
+    }
+
+    QVariantMap nested(int count)
+    {
+        QVariantMap users;
+        for(int i = 0; i < count; ++i) {
+            QVariantMap profile;
+            profile.insert(QStringLiteral("displayName"), QStringLiteral("User %1").arg(i));
+            profile.insert(QStringLiteral("age"), 20 + i % 50);
+
+            QVariantList tags;
+            for(int t = 0; t < 5; ++t)
+                tags.append(QStringLiteral("tag%1").arg(t));
+
+            QVariantMap user;
+            user.insert(QStringLiteral("profile"), profile);
+            user.insert(QStringLiteral("tags"), tags);
+            user.insert(QStringLiteral("scores"), records(5));
+            users.insert(QStringLiteral("uid%1").arg(i, 6, 10, QLatin1Char('0')), user);
+        }
+        return users;
+    }
+
+    QVariantMap deep(int depth)
+    {
+        QVariantMap level;
+        for(int i = depth - 1; i >= 0; --i) {
+            QVariantMap parent;
+            parent.insert(QStringLiteral("depth"), i);
+            parent.insert(QStringLiteral("name"), QStringLiteral("level %1").arg(i));
+            parent.insert(QStringLiteral("values"), QVariantList() << i << i + 1 << i + 2);
+            if(!level.isEmpty())
+                parent.insert(QStringLiteral("next"), level);
+            level = parent;
+        }
+        return level;
+    }
+
+    QVariantMap largeStrings(int count, int size)
+    {
+        QVariantMap map;
+        for(int i = 0; i < count; ++i) {
+            // Mostly ASCII with some multi-byte characters, like real text
+            QString text(size, QLatin1Char('a' + i % 26));
+            for(int c = 0; c < size; c += 64)
+                text[c] = QChar(0x00e9);
+            map.insert(QStringLiteral("text%1").arg(i), text);
+        }
+        return map;
+    }
+
+} // namespace TestTrees
@@ -0,0 +1,20 @@
+#ifndef TEST_TREES_H
+#define TEST_TREES_H
+
+#include <QVariant>
+
+// Generated data trees shared by the benchmarks, deterministic for a given size
+namespace TestTrees {
+    // Map of count scalars of all supported types
+    QVariantMap flatMap(int count);
+    // List of count small records, like a query result
+    QVariantList records(int count);
+    // Users with nested profiles and lists of tags
+    QVariantMap nested(int count);
+    // Chain of depth maps, each level with a few scalars next to the next level
+    QVariantMap deep(int depth);
+    // count strings of size characters each
+    QVariantMap largeStrings(int count, int size);
+}
+
+#endif // TEST_TREES_H
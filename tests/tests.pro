@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+# NOTE built against the desktop SDK only, see qtfirebasetest.pri
+linux:!android {
+    SUBDIRS += \
+        auto \
+        benchmarks \
+
+} else {
+    message("QtFirebase tests: only the linux desktop build is supported")
+}
+
+benchmark.CONFIG = recursive
+benchmark.recurse = benchmarks
+QMAKE_EXTRA_TARGETS += benchmark